@@ -0,0 +1,81 @@
+/*
+ * runs many seeds per formula and compares algorithm variants by flips to solution
+ * example: ./benchmark --runs 100 ../tests/k3-n60-m256-r4.267-s30730906_mod_s1750274_p8.0093584347461e-06.cnf
+ * large instance: ./benchmark --runs 3 --generate /tmp/k3-1M.cnf 1000000 3 4.0
+ * flips per second and thread with 1 to all cores (pinned, copy per NUMA node): ./benchmark --scaling --maxflips 20000000 /tmp/k3-1M.cnf
+ */
+
+#include "benchmark.hpp"
+
+int main(int argc, char **argv)
+{
+	try {
+		param_parse_registry["--help"] = &parse_param_help;
+		param_parse_registry["-h"] = &parse_param_help;
+
+		param_parse_registry["--runs"] = &parse_runs_maxflips_and_seed;
+		param_parse_registry["--maxflips"] = &parse_runs_maxflips_and_seed;
+		param_parse_registry["--seed"] = &parse_runs_maxflips_and_seed;
+
+		param_parse_registry["--clausePick"] = &parse_clause_pick;
+		param_parse_registry["--scaling"] = &parse_scaling;
+		param_parse_registry["--genericClauses"] = &parse_generic_clauses;
+		param_parse_registry["--threads"] = &parse_threads;
+		param_parse_registry["--generate"] = &parse_generate;
+		#if USE_SIMD_BREAK_EVAL
+			param_parse_registry["--simd"] = &parse_simd;
+		#endif
+
+		if (2 > argc) {
+			std::cerr << "usage: " << argv[0] << " [parameters like --help] boolean_formula.cnf [more formulas ...]" << std::endl;
+			exit(EXIT_FAILURE);
+		}
+
+		int params_left = parse_params(argc - 1, &argv[1]);
+
+		if (0 > params_left) {
+			exit(EXIT_FAILURE);
+		} else if ((1 > params_left) && generate.file.empty()) {
+			std::cerr << "at least one boolean formula is required" << std::endl;
+			exit(EXIT_FAILURE);
+		}
+
+		std::vector<std::string> files(&argv[argc - params_left], &argv[argc]);
+		if (!generate.file.empty()) {
+			generate_formula(generate, first_seed);
+			files.push_back(generate.file);
+		}
+
+		std::cout << "c variable state: " << (USE_INTERLEAVED_VAR_STATE ? "interleaved records" : "separate arrays") << std::endl;
+		std::cout << "c clause state: " << (USE_PACKED_CLAUSE_STATE ? "packed records" : "separate arrays") << std::endl;
+		#if USE_SIMD_BREAK_EVAL
+			std::cout << "c break evaluation: " << simd_level_name(used_simd_level()) << std::endl;
+		#endif
+
+		if (thread_scaling) {
+			std::cout << "c thread scaling with up to " << max_threads << " threads, "
+				<< max_flips << " flips per thread" << std::endl;
+			std::cout << "c " << get_pinning_order().size() << " usable cpus on " << get_numa_topology().nodes.size() << " NUMA nodes" << std::endl;
+		} else {
+			std::cout << "c " << num_runs << " runs per variant, seeds " << first_seed << " to "
+				<< (first_seed + num_runs - 1) << ", at most " << max_flips << " flips per run" << std::endl;
+		}
+
+		for (const std::string &fname : files) {
+			std::cout << "c processing: " << fname << std::endl;
+			load_cnf_formula(fname, [](const auto bformula_sptr) {
+				const auto &bformula = *bformula_sptr;
+				std::cout << "c num vars = " << bformula.num_vars() << ", clauses = " << bformula.num_clauses() << std::endl;
+				std::cout << "c data types: " << describe_types(bformula) << std::endl;
+
+				run_benchmarks(bformula);
+			}, !generic_clauses);
+
+			std::cout << std::endl;
+		}
+	} catch (const std::exception& ex) {
+		print_exception("main", ex);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,435 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+// utility header for benchmark.cpp
+
+#include "config.hpp"
+
+#include "util/util.hpp"
+#include "util/parse_params.hpp"
+#include "util/numa.hpp"
+#include "sat/instance.hpp"
+#include "sat/dispatch.hpp"
+#include "sat/probability_functions/polynomial.hpp"
+#include "sat/probability_functions/cached.hpp"
+#include "sat/probability_functions/table.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+
+// algorithm options:
+constexpr bool caching = true;
+
+constexpr bool multithreaded = true;
+constexpr bool manythreads = true;
+
+
+// data type specialications:
+// num_t, sum_t, cnt_t and the clause type are chosen per formula by load_cnf_formula (sat/dispatch.hpp)
+using prec_t = double;
+
+template<typename num_t>
+using poly_prob_func_t = prob_func_polynomial<num_t, prec_t>;
+template<typename num_t>
+using prob_func_t = prob_func_table<num_t, prec_t, poly_prob_func_t<num_t>>;
+template<typename num_t>
+using cached_prob_func_t = prob_func_cached<num_t, prec_t, poly_prob_func_t<num_t>, multithreaded, manythreads>;
+
+using random_generator_t = lin_cong_random_generator;
+
+template<clause_pick_policy pick_policy, class pf_t, class formula_t>
+using serial_instance_t = serial_instance<typename formula_t::num_type, typename formula_t::sum_type, typename formula_t::cnt_type,
+	prec_t, typename formula_t::clause_type, pf_t, random_generator_t, caching, pick_policy>;
+
+
+std::size_t num_runs = 100;
+uint64_t max_flips = 10000000;
+random_generator_t::seed_t first_seed = 1;
+std::vector<clause_pick_policy> pick_policies = {
+	clause_pick_policy::flip_modulo, clause_pick_policy::round_robin, clause_pick_policy::uniform};
+
+bool thread_scaling = false;
+bool generic_clauses = false; // don't use static_clause_k for uniform formulas
+unsigned int max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+// random k-SAT formula written by --generate
+struct generate_options {
+	std::string file;
+	int64_t num_vars = 0;
+	int64_t k = 3;
+	double ratio = 4.2; // clauses per variable
+} generate;
+
+
+struct run_result {
+	bool solved = false;
+	uint64_t num_flips = 0;
+	uint64_t duration = 0; // us
+};
+
+
+std::string to_string(const clause_pick_policy policy) {
+	switch (policy) {
+		case clause_pick_policy::uniform: return "uniform";
+		case clause_pick_policy::round_robin: return "round_robin";
+		case clause_pick_policy::flip_modulo: return "flip_modulo";
+	}
+
+	return "unknown";
+}
+
+
+template<clause_pick_policy pick_policy, class pf_t, class formula_t>
+run_result run_once(const formula_t &bformula, pf_t &pfi, const random_generator_t::seed_t seed) {
+	using instance_t = serial_instance_t<pick_policy, pf_t, formula_t>;
+
+	random_generator_t rgen = random_generator_t(seed);
+	auto belegung = typename instance_t::configuration_type(bformula.num_vars());
+	for (typename formula_t::num_type i = 0; i < bformula.num_vars(); i++) {belegung[i] = rgen.rand() % 2;}
+
+	instance_t solver = instance_t(bformula, pfi, belegung, rgen);
+
+	auto start_solving = std::chrono::high_resolution_clock::now();
+
+	while (!solver.found_solution()) {
+		if ((0 < max_flips) && (max_flips <= solver.get_num_flips())) {
+			break;
+		}
+
+		std::size_t batch_size = FLIP_BATCH_SIZE;
+		if (0 < max_flips) {
+			batch_size = std::min<std::size_t>(batch_size, max_flips - solver.get_num_flips());
+		}
+		solver.do_flips(batch_size);
+	}
+
+	auto done_solving = std::chrono::high_resolution_clock::now();
+
+	run_result result;
+	result.solved = solver.found_solution();
+	result.num_flips = solver.get_num_flips();
+	result.duration = std::chrono::duration_cast<std::chrono::microseconds>(done_solving - start_solving).count();
+	return result;
+}
+
+
+template<class pf_t, class formula_t>
+run_result run_once(const clause_pick_policy policy, const formula_t &bformula, pf_t &pfi, const random_generator_t::seed_t seed) {
+	switch (policy) {
+		case clause_pick_policy::uniform:
+			return run_once<clause_pick_policy::uniform, pf_t>(bformula, pfi, seed);
+		case clause_pick_policy::round_robin:
+			return run_once<clause_pick_policy::round_robin, pf_t>(bformula, pfi, seed);
+		case clause_pick_policy::flip_modulo:
+			return run_once<clause_pick_policy::flip_modulo, pf_t>(bformula, pfi, seed);
+	}
+
+	throw std::runtime_error("unknown clause pick policy");
+}
+
+
+// uniform random k-SAT, every clause has k different variables with random signs
+void generate_formula(const generate_options &opt, const uint64_t seed) {
+	if ((opt.num_vars < opt.k) || (1 > opt.k) || (0. >= opt.ratio)) {
+		throw std::runtime_error("invalid parameters for --generate");
+	}
+
+	std::ofstream os(opt.file);
+	if (!os) {
+		throw std::runtime_error("can't open '" + opt.file + "' for writing");
+	}
+
+	const uint64_t num_clauses = llround(opt.ratio * opt.num_vars);
+	std::mt19937_64 rgen(seed);
+	std::uniform_int_distribution<int64_t> var_dist(1, opt.num_vars);
+	std::vector<int64_t> clause;
+
+	os << "c random " << opt.k << "-SAT, ratio " << opt.ratio << ", seed " << seed << "\n";
+	os << "p cnf " << opt.num_vars << " " << num_clauses << "\n";
+	for (uint64_t i = 0; i < num_clauses; i++) {
+		clause.clear();
+		while (clause.size() < (std::size_t) opt.k) {
+			int64_t var = var_dist(rgen);
+			if (clause.end() == std::find(clause.begin(), clause.end(), var)) {
+				clause.push_back(var);
+			}
+		}
+
+		for (int64_t var : clause) {
+			os << ((rgen() & 1) ? var : -var) << " ";
+		}
+		os << "0\n";
+	}
+
+	if (!os) {
+		throw std::runtime_error("can't write '" + opt.file + "'");
+	}
+}
+
+
+void print_summary(const std::string &name, std::vector<run_result> &results) {
+	std::size_t num_solved = 0;
+	uint64_t total_flips = 0;
+	uint64_t total_duration = 0;
+	std::vector<uint64_t> flips_all;
+
+	for (const auto &r : results) {
+		total_flips += r.num_flips;
+		total_duration += r.duration;
+		flips_all.push_back(r.num_flips);
+		if (r.solved) {
+			num_solved++;
+		}
+	}
+
+	// unsolved runs are counted with max_flips, so the median is a lower bound if less than half of the runs succeeded
+	std::sort(flips_all.begin(), flips_all.end());
+	uint64_t median_flips = flips_all.empty() ? 0 : flips_all[flips_all.size() / 2];
+
+	double mean_flips = results.empty() ? 0. : ((double) total_flips) / results.size();
+	double fps = (0 == total_duration) ? 0. : ((double) total_flips) / total_duration * 1000000.;
+
+	std::cout << "c " << name << ": solved " << num_solved << " / " << results.size()
+		<< ", median flips " << median_flips
+		<< ", mean flips " << round(mean_flips)
+		<< ", " << round(fps) << " flips per second" << std::endl;
+}
+
+
+// runs 1, 2, 4, ... max_threads solvers simultaneously which share the formula and the probability function,
+// pinned threads are bound to the cpus in get_pinning_order() and use formulas[i] and pfis[i] of their NUMA node index i
+template<class pf_t, class formula_t>
+void run_thread_scaling(const std::string &name, const std::vector<const formula_t*> &formulas, const std::vector<pf_t*> &pfis, const bool pinned) {
+	const std::vector<int> cpus = get_pinning_order();
+
+	for (unsigned int num_threads = 1; ; num_threads = std::min(2 * num_threads, max_threads)) {
+		std::vector<run_result> results(num_threads);
+		std::vector<std::thread> threads;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (unsigned int i = 0; i < num_threads; i++) {
+			threads.push_back(std::thread([&, i]() {
+				std::size_t node = 0;
+				if (pinned && pin_current_thread(cpus[i % cpus.size()])) {
+					node = std::min(get_current_numa_node_index(), formulas.size() - 1);
+				}
+				results[i] = run_once<clause_pick_policy::flip_modulo, pf_t>(*formulas[node], *pfis[node], first_seed + i);
+			}));
+		}
+		for (auto &t : threads) { t.join(); }
+		auto done = std::chrono::high_resolution_clock::now();
+		auto duration = std::chrono::duration_cast<std::chrono::microseconds>(done - start).count();
+
+		uint64_t total_flips = 0;
+		double fps_per_thread = 0.;
+		for (const auto &r : results) {
+			total_flips += r.num_flips;
+			fps_per_thread += (0 == r.duration) ? 0. : ((double) r.num_flips) / r.duration * 1000000. / num_threads;
+		}
+
+		std::cout << "c " << name << ", " << num_threads << " threads: "
+			<< round(((double) total_flips) / duration * 1000000.) << " flips per second, "
+			<< round(fps_per_thread) << " per thread" << std::endl;
+
+		if (max_threads <= num_threads) { break; }
+	}
+}
+
+
+// all variants for one formula
+template<class formula_t>
+void run_benchmarks(const formula_t &bformula) {
+	using num_t = typename formula_t::num_type;
+	prob_func_t<num_t> pfi = prob_func_t<num_t>(poly_prob_func_t<num_t>(), bformula.get_max_num_breaks_possible());
+
+	if (thread_scaling) {
+		poly_prob_func_t<num_t> direct_pfi = poly_prob_func_t<num_t>();
+		cached_prob_func_t<num_t> cached_pfi = cached_prob_func_t<num_t>(poly_prob_func_t<num_t>());
+
+		run_thread_scaling<prob_func_t<num_t>, formula_t>("table", {&bformula}, {&pfi}, false);
+		run_thread_scaling<cached_prob_func_t<num_t>, formula_t>("cached", {&bformula}, {&cached_pfi}, false);
+		run_thread_scaling<poly_prob_func_t<num_t>, formula_t>("direct", {&bformula}, {&direct_pfi}, false);
+
+		// as in the worker: pinned threads, the formula and the table are copied by a thread on every NUMA node
+		const auto replicas = run_on_every_numa_node([&]() {
+			std::shared_ptr<const formula_t> local_formula = bformula.make_local_copy();
+			auto local_pfi = std::make_shared<prob_func_t<num_t>>(poly_prob_func_t<num_t>(), local_formula->get_max_num_breaks_possible());
+			return std::make_pair(local_formula, local_pfi);
+		});
+		std::vector<const formula_t*> local_formulas;
+		std::vector<prob_func_t<num_t>*> local_pfis;
+		for (const auto &r : replicas) {
+			local_formulas.push_back(r.first.get());
+			local_pfis.push_back(r.second.get());
+		}
+
+		run_thread_scaling<prob_func_t<num_t>, formula_t>("table, pinned", {&bformula}, {&pfi}, true);
+		run_thread_scaling<prob_func_t<num_t>>("table, pinned, copy per node", local_formulas, local_pfis, true);
+		return;
+	}
+
+	for (auto policy : pick_policies) {
+		std::vector<run_result> results;
+		results.reserve(num_runs);
+
+		for (std::size_t run = 0; run < num_runs; run++) {
+			results.push_back(run_once(policy, bformula, pfi, first_seed + run));
+		}
+
+		print_summary(to_string(policy), results);
+	}
+}
+
+
+void parse_param_help(std::queue<std::string> &params) {
+	std::cerr << "usage: ./benchmark [parameters] boolean_formula.cnf [more formulas ...]" << std::endl;
+	std::cout << "parameters:" << std::endl;
+	std::cout << "\t--help\t\t-h\tprint this help message [flag]" << std::endl;
+	std::cout << "\t--runs <n>\t\tnumber of seeds per formula and variant [default: n = 100]" << std::endl;
+	std::cout << "\t--seed <seed>\t\tfirst seed, run i uses seed + i [default: 1]" << std::endl;
+	std::cout << "\t--maxflips <m>\t\tmaximum number of flips per run [default: m = 10000000, 0 = infinity]" << std::endl;
+	std::cout << "\t--clausePick <p>\tclause pick policy: uniform, round_robin, flip_modulo or all [default: all]" << std::endl;
+	std::cout << "\t--scaling\t\tmeasure flips per second with 1 to max. threads sharing one formula, also pinned and with a copy per NUMA node [flag]" << std::endl;
+	std::cout << "\t--threads <t>\t\tmaximum number of threads used by --scaling [default: hardware concurrency]" << std::endl;
+	std::cout << "\t--genericClauses\t\tdon't use static clauses for uniform 3-, 5- and 7-SAT formulas [flag]" << std::endl;
+	std::cout << "\t--generate <f> <n> <k> <r>\twrite a random k-SAT formula with n variables and r * n clauses to f and benchmark it" << std::endl;
+	#if USE_SIMD_BREAK_EVAL
+		std::cout << "\t--simd <s>\t\tinstruction set for wide clauses: scalar, avx2 or avx512 [default: best supported]" << std::endl;
+	#endif
+
+	ignore(params);
+	exit(EXIT_SUCCESS);
+}
+
+void parse_clause_pick(std::queue<std::string> &params) {
+	params.pop();
+
+	if (params.empty()) {
+		throw std::runtime_error("clause pick policy is required");
+	}
+
+	std::string p = params.front();
+	if ("uniform" == p) {
+		pick_policies = {clause_pick_policy::uniform};
+	} else if ("round_robin" == p) {
+		pick_policies = {clause_pick_policy::round_robin};
+	} else if ("flip_modulo" == p) {
+		pick_policies = {clause_pick_policy::flip_modulo};
+	} else if ("all" != p) {
+		throw std::runtime_error("unknown clause pick policy '" + p + "'");
+	}
+
+	params.pop();
+}
+
+void parse_scaling(std::queue<std::string> &params) {
+	params.pop();
+	thread_scaling = true;
+}
+
+void parse_generic_clauses(std::queue<std::string> &params) {
+	params.pop();
+	generic_clauses = true;
+}
+
+#if USE_SIMD_BREAK_EVAL
+void parse_simd(std::queue<std::string> &params) {
+	params.pop();
+
+	if (params.empty()) {
+		throw std::runtime_error("instruction set is required");
+	}
+
+	std::string s = params.front();
+	simd_level level;
+	if ("scalar" == s) {
+		level = simd_level::scalar;
+	} else if ("avx2" == s) {
+		level = simd_level::avx2;
+	} else if ("avx512" == s) {
+		level = simd_level::avx512;
+	} else {
+		throw std::runtime_error("unknown instruction set '" + s + "'");
+	}
+
+	if (detect_simd_level() < level) {
+		throw std::runtime_error("instruction set '" + s + "' is not supported by this cpu");
+	}
+	used_simd_level() = level;
+
+	params.pop();
+}
+#endif
+
+void parse_threads(std::queue<std::string> &params) {
+	params.pop();
+
+	if (params.empty()) {
+		throw std::runtime_error("number of threads is required");
+	}
+
+	std::istringstream iss(params.front());
+	iss >> max_threads;
+	if ((!iss) || (0 == max_threads)) {
+		std::string errmsg = "can't parse '"
+			+ params.front() + "' as number of threads";
+		throw std::runtime_error(errmsg);
+	}
+
+	params.pop();
+}
+
+void parse_generate(std::queue<std::string> &params) {
+	params.pop();
+
+	if (4 > params.size()) {
+		throw std::runtime_error("--generate requires file, number of variables, k and ratio");
+	}
+
+	generate.file = params.front(); params.pop();
+
+	std::string values = params.front(); params.pop();
+	values += " " + params.front(); params.pop();
+	values += " " + params.front(); params.pop();
+
+	std::istringstream iss(values);
+	iss >> generate.num_vars >> generate.k >> generate.ratio;
+	if (!iss) {
+		throw std::runtime_error("can't parse '" + values + "' as number of variables, k and ratio");
+	}
+}
+
+void parse_runs_maxflips_and_seed(std::queue<std::string> &params) {
+	std::string type = params.front(); params.pop();
+	std::string pmsg = ("--seed" == type) ? "seed" : (("--runs" == type) ? "number of runs" : "maximum number of flips");
+
+	if (params.empty()) {
+		std::string errmsg = pmsg + " is required";
+		throw std::runtime_error(errmsg);
+	}
+
+	std::istringstream iss(params.front());
+	if ("--seed" == type) {
+		iss >> first_seed;
+	} else if ("--runs" == type) {
+		iss >> num_runs;
+	} else {
+		iss >> max_flips;
+	}
+	if (!iss) {
+		std::string errmsg = "can't parse '"
+			+ params.front() + "' as " + pmsg;
+		throw std::runtime_error(errmsg);
+	}
+
+	params.pop();
+}
+
+#endif
@@ -0,0 +1,55 @@
+/*
+ * converts a DIMACS formula into the binary format that is mapped instead of parsed (see sat/binary_formula.hpp)
+ * example: ./cnf2bin /tmp/k3-1M.cnf /tmp/k3-1M.psat
+ * the binary file can be passed to probsat, benchmark and the manager like a DIMACS file
+ */
+
+#include "config.hpp"
+
+#include "util/util.hpp"
+#include "sat/dispatch.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#if !(USE_FLAT_CLAUSE_STORAGE && USE_CONT_DATASTRUCT)
+	#error "the binary formula format requires USE_FLAT_CLAUSE_STORAGE and USE_CONT_DATASTRUCT"
+#endif
+
+int main(int argc, char **argv)
+{
+	if (3 != argc) {
+		std::cerr << "usage: " << argv[0] << " boolean_formula.cnf output.psat" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const std::string input = argv[1];
+	const std::string output = argv[2];
+
+	try {
+		auto start = std::chrono::high_resolution_clock::now();
+
+		// the types and the clause layout are those the solvers would use for the formula
+		load_cnf_formula(input, [&](const auto bformula_sptr) {
+			const auto &bformula = *bformula_sptr;
+			std::cout << "c num vars = " << std::to_string(bformula.num_vars()) << std::endl;
+			std::cout << "c clauses = " << std::to_string(bformula.num_clauses()) << std::endl;
+			std::cout << "c data types: " << describe_types(bformula) << std::endl;
+
+			auto imported = std::chrono::high_resolution_clock::now();
+			std::cout << "c import duration: " << std::chrono::duration_cast<std::chrono::milliseconds>(imported - start).count() << " ms" << std::endl;
+
+			bformula.save_binary(output);
+
+			auto written = std::chrono::high_resolution_clock::now();
+			std::cout << "c write duration: " << std::chrono::duration_cast<std::chrono::milliseconds>(written - imported).count() << " ms" << std::endl;
+		});
+	} catch (const std::exception& ex) {
+		print_exception("main", ex);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
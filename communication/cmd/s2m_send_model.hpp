@@ -0,0 +1,42 @@
+#ifndef S2M_SEND_MODEL_HPP
+#define S2M_SEND_MODEL_HPP
+
+// Der Server leitet einen Teil der gefundenen Belegung an den Manager weiter (folgt auf FOUND_SOLUTION)
+
+#include "ws_typedefs.hpp"
+
+
+class send_model {
+	public:
+		model_chunk chunk;
+
+		send_model() {}
+		send_model(model_chunk mchunk) : chunk(std::move(mchunk)) {}
+
+	#if BUILD_SERVER
+		void send() {
+			command_buffer.clear();
+			auto data_len = bitsery::quickSerialization(output_adapter_t{command_buffer}, chunk);
+			ensure_cmd_length(data_len);
+			MPI_Send(command_buffer.data(), data_len, MPI_BYTE, manager_id, S2M::SEND_MODEL, manager_cl);
+		}
+	#endif
+
+	#if BUILD_MANAGER
+		void process(MPI_Status &status) {
+			#if DEBUG_COMMUNICATION
+				std::cout << msg_header << "recieved SEND_MODEL command (" << status.MPI_TAG << ") from " << status.MPI_SOURCE << std::endl;
+			#endif
+
+			#if ADDITIONAL_CHECKS
+				assert(SEND_MODEL == status.MPI_TAG);
+			#endif
+
+			int num_bytes = get_bytes_recieved_safe(status, "SEND_MODEL", 0, command_buffer.capacity());
+			safe_deserialization(input_adapter_t{command_buffer.begin(), (std::size_t) num_bytes}, chunk, "SEND_MODEL");
+			command_buffer.clear();
+		}
+	#endif
+};
+
+#endif
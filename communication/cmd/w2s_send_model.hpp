@@ -0,0 +1,42 @@
+#ifndef W2S_SEND_MODEL_HPP
+#define W2S_SEND_MODEL_HPP
+
+// Der Worker sendet einen Teil der gefundenen Belegung (folgt auf FOUND_SOLUTION)
+
+#include "ws_typedefs.hpp"
+
+
+class send_model {
+	public:
+		model_chunk chunk;
+
+		send_model() {}
+		send_model(model_chunk mchunk) : chunk(std::move(mchunk)) {}
+
+	#if BUILD_WORKER
+		void send() {
+			command_buffer.clear();
+			auto data_len = bitsery::quickSerialization(output_adapter_t{command_buffer}, chunk);
+			ensure_cmd_length(data_len);
+			MPI_Send(command_buffer.data(), data_len, MPI_BYTE, server_id, W2S::SEND_MODEL, server_cl);
+		}
+	#endif
+
+	#if BUILD_SERVER
+		void process(int index, MPI_Status &status) {
+			#if DEBUG_COMMUNICATION
+				std::cout << msg_header << "recieved SEND_MODEL command (" << status.MPI_TAG << ") from " << status.MPI_SOURCE << std::endl;
+			#endif
+
+			#if ADDITIONAL_CHECKS
+				assert(SEND_MODEL == status.MPI_TAG);
+			#endif
+
+			int num_bytes = get_bytes_recieved_safe(status, "SEND_MODEL", 0, worker_comm_buffers[index].capacity());
+			safe_deserialization(input_adapter_t{worker_comm_buffers[index].begin(), (std::size_t) num_bytes}, chunk, "SEND_MODEL");
+			worker_comm_buffers[index].clear();
+		}
+	#endif
+};
+
+#endif
@@ -35,6 +35,13 @@ struct done_processing_info {
 	uint64_t num_vars = 0;
 	uint64_t num_clauses = 0;
 	bool solved = false;
+	// best try of the task (MaxSAT like), 0 unsat clauses if solved
+	uint64_t min_unsat_clauses = std::numeric_limits<uint64_t>::max();
+	uint64_t min_unsat_flips = 0; // flips of this try until the minimum was reached
+	uint64_t min_unsat_seed = 0;
+	// checksum (bitfield::hash) of the assignment of the best try of an unsolved task, which follows in SEND_MODEL chunks,
+	// 0 if there is none
+	uint64_t min_unsat_hash = 0;
 };
 
 template <typename S>
@@ -50,6 +57,10 @@ void serialize (S& s, done_processing_info& o) {
 	s.value8b(o.num_vars);
 	s.value8b(o.num_clauses);
 	s.value1b(o.solved);
+	s.value8b(o.min_unsat_clauses);
+	s.value8b(o.min_unsat_flips);
+	s.value8b(o.min_unsat_seed);
+	s.value8b(o.min_unsat_hash);
 }
 
 
@@ -64,6 +75,11 @@ struct problem_instance_statistics {
 	uint64_t num_clauses = 0;
 	uint64_t times_solved = 0;
 	uint64_t min_flips_to_solve = std::numeric_limits<uint64_t>::max();
+	uint64_t min_unsat_clauses = std::numeric_limits<uint64_t>::max(); // over all tries
+	uint64_t min_unsat_seed = 0; // seed of the try with min_unsat_clauses
+	uint64_t model_hash = 0; // checksum of the first model received, 0 if there is none
+	// checksum of the best assignment of an unsolved file, it follows SEND_STATISTICS in SEND_MODEL chunks, 0 if there is none
+	uint64_t min_unsat_hash = 0;
 };
 
 template <typename S>
@@ -78,6 +94,10 @@ void serialize (S& s, problem_instance_statistics& o) {
 	s.value8b(o.num_clauses);
 	s.value8b(o.times_solved);
 	s.value8b(o.min_flips_to_solve);
+	s.value8b(o.min_unsat_clauses);
+	s.value8b(o.min_unsat_seed);
+	s.value8b(o.model_hash);
+	s.value8b(o.min_unsat_hash);
 }
 
 
@@ -107,6 +127,9 @@ struct solution_info {
 	uint64_t num_vars = 0;
 	uint64_t num_clauses = 0;
 	std::string filename;
+	uint32_t task_id = 0;
+	// FNV-1a over the bit packed model (bitfield::hash), the model follows in SEND_MODEL chunks
+	uint64_t model_hash = 0;
 };
 
 template <typename S>
@@ -116,7 +139,29 @@ void serialize (S& s, solution_info& o) {
 	s.value8b(o.solve_duration);
 	s.value8b(o.num_vars);
 	s.value8b(o.num_clauses);
-	s.text1b(o.filename, absolute_max_cmd_length - 16);
+	s.text1b(o.filename, absolute_max_cmd_length - 64);
+	s.value4b(o.task_id);
+	s.value8b(o.model_hash);
+}
+
+
+// part of a bit packed model, variable i (0 based) is bit i % 64 of word i / 64 like in bitfield
+struct model_chunk {
+	uint64_t model_hash = 0; // of the whole model
+	uint64_t num_vars = 0; // of the whole model
+	uint64_t first_word = 0; // index of words[0] in the model
+	std::vector<uint64_t> words;
+};
+
+// a chunk with header fits into absolute_max_cmd_length bytes
+constexpr const std::size_t max_model_chunk_words = (absolute_max_cmd_length - 64) / sizeof(uint64_t);
+
+template <typename S>
+void serialize (S& s, model_chunk& o) {
+	s.value8b(o.model_hash);
+	s.value8b(o.num_vars);
+	s.value8b(o.first_word);
+	s.container8b(o.words, max_model_chunk_words);
 }
 
 
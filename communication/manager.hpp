@@ -5,6 +5,7 @@
 
 #define BUILD_MANAGER 1
 #include "manager_server.hpp"
+#include "model_transfer.hpp"
 
 #include <vector>
 #include <iostream>
@@ -27,6 +28,15 @@
 
 bool solution_found = false;
 
+// model of the last FOUND_SOLUTION, the server sends its chunks directly afterwards
+solution_info model_info;
+model_assembly model_in_transfer;
+
+// best assignment of an unsolved file (MaxSAT like), the server sends its chunks directly after the statistics
+S2M::report_entry best_assignment_info;
+model_assembly best_assignment_in_transfer;
+bool receiving_best_assignment = false;
+
 
 MPI_Comm do_add_workers(const int num_workers, MPI_Info &info, const std::vector<std::string> worker_argv)
 {
@@ -168,9 +178,52 @@ void process_s2m_SEND_STATISTICS(MPI_Status &status)
 		outp_stat(stat.total_overall_duration << " total overall duration (us)")
 		outp_stat(stat.times_solved << " times solved")
 		outp_stat(stat.min_flips_to_solve << " flips until solved (min)")
+		outp_stat(stat.min_unsat_clauses << " unsatisfied clauses (min, seed " << stat.min_unsat_seed << ")")
+		if (0 != stat.model_hash) {
+			outp_stat(stat.model_hash << " model checksum")
+		}
 		if (output_to_file) { output_file << std::endl; }
 		if (output_to_stdout) { std::cout << std::endl; }
 	#endif
+
+	if (0 != stat.min_unsat_hash) {
+		best_assignment_info = scmd.data;
+		best_assignment_in_transfer = model_assembly(stat.num_vars, stat.min_unsat_hash);
+		receiving_best_assignment = true;
+	}
+}
+
+
+void write_model_out() {
+	if (!model_in_transfer.verify()) {
+		throw std::runtime_error(std::string(msg_header) + "the model received for " + model_info.filename + " doesn't match its checksum");
+	}
+
+	if (output_to_stdout) { write_model(std::cout, model_in_transfer.get_model()); std::cout << std::endl; }
+	if (output_to_file) { write_model(output_file, model_in_transfer.get_model()); output_file << std::endl; }
+}
+
+
+// "o" line with the number of unsatisfied clauses (MaxSAT output format) and the assignment as "v" lines
+void write_best_assignment_out() {
+	const auto &mdat = best_assignment_info.metadata;
+	const auto &stat = best_assignment_info.statistics;
+
+	if (!best_assignment_in_transfer.verify()) {
+		throw std::runtime_error(std::string(msg_header) + "the best assignment received for " + mdat.filename + " doesn't match its checksum");
+	}
+
+	outp_stat("best assignment of " << mdat.filename << " (checksum " << stat.min_unsat_hash << ")")
+	if (output_to_stdout) {
+		std::cout << "o " << stat.min_unsat_clauses << std::endl;
+		write_model(std::cout, best_assignment_in_transfer.get_model());
+		std::cout << std::endl;
+	}
+	if (output_to_file) {
+		output_file << "o " << stat.min_unsat_clauses << std::endl;
+		write_model(output_file, best_assignment_in_transfer.get_model());
+		output_file << std::endl;
+	}
 }
 
 
@@ -196,8 +249,33 @@ void process_s2m_FOUND_SOLUTION(MPI_Status &status) {
 	outp_stat("flips per var: " << fpv)
 	auto fpc = ((double) fs_cmd.info.num_flips_done / fs_cmd.info.num_clauses);
 	outp_stat("flips per clause: " << fpc)
-	if (output_to_file) { output_file << std::endl; }
-	if (output_to_stdout) { std::cout << std::endl; }
+	outp_stat("model checksum: " << fs_cmd.info.model_hash)
+
+	model_info = fs_cmd.info;
+	model_in_transfer = model_assembly(fs_cmd.info);
+	if (model_in_transfer.complete()) {
+		write_model_out();
+	}
+}
+
+
+void process_s2m_SEND_MODEL(MPI_Status &status) {
+	S2M::send_model sm_cmd;
+	sm_cmd.process(status);
+
+	if (receiving_best_assignment) {
+		best_assignment_in_transfer.add(sm_cmd.chunk);
+		if (best_assignment_in_transfer.complete()) {
+			receiving_best_assignment = false;
+			write_best_assignment_out();
+		}
+		return;
+	}
+
+	model_in_transfer.add(sm_cmd.chunk);
+	if (model_in_transfer.complete()) {
+		write_model_out();
+	}
 }
 
 
@@ -209,10 +287,18 @@ void process_server_cmd(MPI_Status &status)
 	#endif
 
 	switch (status.MPI_TAG) {
+		case S2M::REQ_MAX_CMD_LENGTH:
+			S2M::req_max_transfer_size::process(status);
+			break;
+
 		case S2M::FOUND_SOLUTION:
 			process_s2m_FOUND_SOLUTION(status);
 			break;
 
+		case S2M::SEND_MODEL:
+			process_s2m_SEND_MODEL(status);
+			break;
+
 		case S2M::SEND_STATISTICS:
 			process_s2m_SEND_STATISTICS(status);
 			break;
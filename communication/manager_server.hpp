@@ -60,7 +60,8 @@ namespace S2M {
 		REQ_MAX_CMD_LENGTH = 1,
 		FOUND_SOLUTION,
 		SEND_STATISTICS,
-		DISCONNECT
+		DISCONNECT,
+		SEND_MODEL
 	};
 
 	// include generic implementation:
@@ -81,6 +82,7 @@ namespace S2M {
 	#include "cmd/s2m_found_solution.hpp"
 	#include "cmd/s2m_send_statistics.hpp"
 	#include "cmd/s2m_disconnect.hpp"
+	#include "cmd/s2m_send_model.hpp"
 }
 
 static_assert((int) M2S::REQ_MAX_CMD_LENGTH == (int) S2M::REQ_MAX_CMD_LENGTH);
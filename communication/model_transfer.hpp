@@ -0,0 +1,103 @@
+#ifndef MODEL_TRANSFER_HPP
+#define MODEL_TRANSFER_HPP
+
+// Übertragung einer erfüllenden Belegung in Teilstücken (Worker -> Server -> Manager)
+
+#include "cmd/ws_typedefs.hpp"
+#include "../util/bitfield.hpp"
+
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+
+// number of SEND_MODEL chunks of a model with num_words words
+std::size_t num_model_chunks(const std::size_t num_words);
+
+// chunk index of model (max_model_chunk_words words each)
+model_chunk make_model_chunk(const bitfield<int64_t> &model, const uint64_t model_hash, const std::size_t index);
+
+// collects the chunks of one model, they may arrive in any order but must not overlap
+class model_assembly {
+	private:
+		bitfield<int64_t> model;
+		uint64_t model_hash;
+		std::size_t words_received;
+
+	public:
+		model_assembly() : model(), model_hash(0), words_received(0) {}
+		model_assembly(const uint64_t num_vars, const uint64_t hash) : model((int64_t) num_vars), model_hash(hash), words_received(0) {}
+		model_assembly(const solution_info &info) : model_assembly(info.num_vars, info.model_hash) {}
+
+		// throws if the chunk doesn't belong to this model
+		void add(const model_chunk &chunk);
+
+		bool complete() const {
+			return words_received == model.num_words();
+		}
+
+		// compares the checksum of the solution_info with the received words
+		bool verify() const {
+			return complete() && (model.hash() == model_hash);
+		}
+
+		const bitfield<int64_t>& get_model() const {
+			return model;
+		}
+};
+
+// DIMACS "v" lines with vars_per_line literals each, terminated by 0
+void write_model(std::ostream &os, const bitfield<int64_t> &model, const std::size_t vars_per_line = 16);
+
+
+// *********************************************************************
+// Implementation:
+// *********************************************************************
+
+inline std::size_t num_model_chunks(const std::size_t num_words) {
+	return (num_words + max_model_chunk_words - 1) / max_model_chunk_words;
+}
+
+
+inline model_chunk make_model_chunk(const bitfield<int64_t> &model, const uint64_t model_hash, const std::size_t index) {
+	const std::size_t first = index * max_model_chunk_words;
+	const std::size_t last = std::min(first + max_model_chunk_words, model.num_words());
+	assert(first < last);
+
+	model_chunk chunk;
+	chunk.model_hash = model_hash;
+	chunk.num_vars = model.size();
+	chunk.first_word = first;
+	chunk.words.assign(model.words() + first, model.words() + last);
+	return chunk;
+}
+
+
+inline void model_assembly::add(const model_chunk &chunk) {
+	if ((chunk.model_hash != model_hash) || (chunk.num_vars != (uint64_t) model.size())
+		|| (chunk.first_word + chunk.words.size() > model.num_words()))
+	{
+		throw std::runtime_error("received model chunk (word " + std::to_string(chunk.first_word)
+			+ ") doesn't belong to the announced model");
+	}
+
+	model.set_words(chunk.first_word, chunk.words.data(), chunk.words.size());
+	words_received += chunk.words.size();
+}
+
+
+inline void write_model(std::ostream &os, const bitfield<int64_t> &model, const std::size_t vars_per_line) {
+	assert(0 < vars_per_line);
+
+	os << "v";
+	for (int64_t i = 0; i < model.size(); i++) {
+		if ((0 < i) && (0 == ((std::size_t) i) % vars_per_line)) {
+			os << std::endl << "v";
+		}
+		os << " " << (model.get(i) ? (i+1) : -(i+1));
+	}
+	os << " 0" << std::endl;
+}
+
+#endif
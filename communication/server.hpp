@@ -7,9 +7,11 @@
 #include "cmd/ws_typedefs.hpp"
 #include "manager_server.hpp"
 #include "server_worker.hpp"
+#include "model_transfer.hpp"
 
 #include <vector>
 #include <deque>
+#include <map>
 #include <string.h>
 #include <cmath>
 
@@ -20,13 +22,23 @@ struct task_info {
 	uint32_t num_currently_processing;
 	bool is_scheduled;
 
-	task_info(problem_instance_metadata data) : metadata(data), statistics(), num_currently_processing(0), is_scheduled(true) {}
+	// assignment with the least unsatisfied clauses received so far (statistics.min_unsat_hash), sent with the statistics
+	bitfield<int64_t> best_assignment;
+	uint64_t best_assignment_unsat_clauses;
+
+	task_info(problem_instance_metadata data) : metadata(data), statistics(), num_currently_processing(0), is_scheduled(true),
+		best_assignment(), best_assignment_unsat_clauses(std::numeric_limits<uint64_t>::max()) {}
 };
 
 std::vector<task_info> available_tasks;
 std::deque<uint32_t> task_order;
 std::vector<MPI_Request> work_unit_requests;
 
+// solutions whose model is still transferred by the worker (index of the work unit)
+std::map<int, std::pair<solution_info, model_assembly>> models_in_transfer;
+// best assignments of unsolved tasks which are still transferred by the worker (index of the work unit)
+std::map<int, std::pair<done_processing_info, model_assembly>> best_assignments_in_transfer;
+
 
 const char *server_name = nullptr;
 MPI_Info server_info = MPI_INFO_NULL;
@@ -194,6 +206,32 @@ void process_w2s_REQ_MAX_CMD_LENGTH(int index, MPI_Status &status)
 }
 
 
+// sends the solution and its model in one piece, so the manager doesn't see chunks of several models interleaved
+void forward_model(int index) {
+	const auto &[info, assembly] = models_in_transfer[index];
+
+	if (!assembly.verify()) {
+		throw std::runtime_error(std::string(msg_header) + "the model received for " + info.filename + " doesn't match its checksum");
+	}
+
+	problem_instance_statistics &s = available_tasks[info.task_id].statistics;
+	if (0 == s.model_hash) {
+		s.model_hash = info.model_hash;
+	}
+
+	S2M::found_solution fs_mng_cmd(info);
+	fs_mng_cmd.send();
+
+	const auto &model = assembly.get_model();
+	for (std::size_t i = 0; i < num_model_chunks(model.num_words()); i++) {
+		S2M::send_model sm_cmd(make_model_chunk(model, info.model_hash, i));
+		sm_cmd.send();
+	}
+
+	models_in_transfer.erase(index);
+}
+
+
 void process_w2s_FOUND_SOLUTION(int index, MPI_Status &status) {
 	W2S::found_solution fs_cmd;
 	fs_cmd.process(index, status);
@@ -217,8 +255,61 @@ void process_w2s_FOUND_SOLUTION(int index, MPI_Status &status) {
 		send_termination_to_workers();
 	}
 
-	S2M::found_solution fs_mng_cmd(fs_cmd.info);
-	fs_mng_cmd.send();
+	// forwarded to the manager once the model is complete
+	models_in_transfer[index] = {fs_cmd.info, model_assembly(fs_cmd.info)};
+	if (models_in_transfer[index].second.complete()) {
+		forward_model(index);
+	}
+}
+
+
+// keeps the received best assignment if it's better than the one of the task
+void store_best_assignment(int index) {
+	const auto &[info, assembly] = best_assignments_in_transfer[index];
+
+	if (!assembly.verify()) {
+		throw std::runtime_error(std::string(msg_header) + "the best assignment received for task "
+			+ std::to_string(info.task_id) + " doesn't match its checksum");
+	}
+
+	task_info &t = available_tasks[info.task_id];
+	if (info.min_unsat_clauses < t.best_assignment_unsat_clauses) {
+		t.best_assignment = assembly.get_model();
+		t.best_assignment_unsat_clauses = info.min_unsat_clauses;
+		t.statistics.min_unsat_hash = info.min_unsat_hash;
+	}
+
+	best_assignments_in_transfer.erase(index);
+}
+
+
+void check_all_instances_returned();
+
+
+void process_w2s_SEND_MODEL(int index, MPI_Status &status) {
+	W2S::send_model sm_cmd;
+	sm_cmd.process(index, status);
+
+	// the chunks of a solution precede DONE_PROCESSING, the ones of a best assignment follow it
+	auto it = models_in_transfer.find(index);
+	if (models_in_transfer.end() != it) {
+		it->second.second.add(sm_cmd.chunk);
+		if (it->second.second.complete()) {
+			forward_model(index);
+		}
+		return;
+	}
+
+	auto best_it = best_assignments_in_transfer.find(index);
+	if (best_assignments_in_transfer.end() == best_it) {
+		throw std::runtime_error(std::string(msg_header) + "received a model chunk without a solution or best assignment");
+	}
+
+	best_it->second.second.add(sm_cmd.chunk);
+	if (best_it->second.second.complete()) {
+		store_best_assignment(index);
+		check_all_instances_returned();
+	}
 }
 
 
@@ -227,11 +318,24 @@ void send_statistic_to_manager()
 	if (statistic_send) return;
 	statistic_send = true;
 
-	for (auto t : available_tasks) {
+	for (const auto &t : available_tasks) {
 		// std::cout << "INFO: " << t.metadata.filename << std::endl;
 		if ((0 < t.statistics.num_instances_started) || (!short_statistic)) {
-			S2M::send_statistics scmd = S2M::send_statistics({t.metadata, t.statistics});
+			S2M::report_entry re = {t.metadata, t.statistics};
+			if (0 < re.statistics.times_solved) {
+				re.statistics.min_unsat_hash = 0; // the model of the solution was sent instead
+			}
+
+			S2M::send_statistics scmd = S2M::send_statistics(re);
 			scmd.send();
+
+			// the manager expects the chunks directly after the statistics
+			if (0 != re.statistics.min_unsat_hash) {
+				for (std::size_t i = 0; i < num_model_chunks(t.best_assignment.num_words()); i++) {
+					S2M::send_model sm_cmd(make_model_chunk(t.best_assignment, re.statistics.min_unsat_hash, i));
+					sm_cmd.send();
+				}
+			}
 		}
 	}
 
@@ -270,6 +374,11 @@ void process_w2s_DONE_PROCESSING(int index, MPI_Status &status)
 		s.min_flips_to_solve = std::min(s.min_flips_to_solve, msg.num_flips_done);
 	}
 
+	if (msg.min_unsat_clauses < s.min_unsat_clauses) {
+		s.min_unsat_clauses = msg.min_unsat_clauses;
+		s.min_unsat_seed = msg.min_unsat_seed;
+	}
+
 	assert(num_instances_in_processing >= msg.instances_processed);
 	num_instances_in_processing -= msg.instances_processed;
 
@@ -286,11 +395,27 @@ void process_w2s_DONE_PROCESSING(int index, MPI_Status &status)
 		}
 	}
 	
+	// the best assignment of an unsolved task follows in chunks
+	if ((!msg.solved) && (0 != msg.min_unsat_hash)) {
+		best_assignments_in_transfer[index] = {msg, model_assembly(msg.num_vars, msg.min_unsat_hash)};
+		if (!best_assignments_in_transfer[index].second.complete()) {
+			return;
+		}
+		store_best_assignment(index);
+	}
+
+	check_all_instances_returned();
+}
+
+
+void check_all_instances_returned() {
 	// std::cout << "process_w2s_DONE_PROCESSING:" << std::endl;
 	// std::cout << "num_instances_in_processing: " << num_instances_in_processing << std::endl;
 	// std::cout << "task_order.empty(): " << task_order.empty() << std::endl;
 	// std::cout << "solution_found: " << solution_found << std::endl;
-	if ((task_order.empty() || (solution_found && terminate_after_solution_was_found)) && (0 == num_instances_in_processing)) {
+	if ((task_order.empty() || (solution_found && terminate_after_solution_was_found)) && (0 == num_instances_in_processing)
+		&& best_assignments_in_transfer.empty())
+	{
 	// if ((task_order.empty()) && (0 == num_instances_in_processing)) {
 		// all requests were returned
 		#if DEBUG_COMMUNICATION
@@ -304,6 +429,19 @@ void process_w2s_DONE_PROCESSING(int index, MPI_Status &status)
 	}
 }
 
+// the transfers are indexed by work unit, the work units after a disconnected one move down by one
+template<typename transfer_map_t>
+void shift_transfers_after(transfer_map_t &transfers, const int index) {
+	transfer_map_t shifted;
+	for (auto &[i, transfer] : transfers) {
+		if (i != index) {
+			shifted.emplace((i < index) ? i : (i - 1), std::move(transfer));
+		}
+	}
+	transfers = std::move(shifted);
+}
+
+
 void process_w2s_DISCONNECT(int index, MPI_Status &status) {
 	#if DEBUG_COMMUNICATION
 		std::cout << msg_header << "worker " << index << " disconnected" << std::endl;
@@ -317,6 +455,8 @@ void process_w2s_DISCONNECT(int index, MPI_Status &status) {
 
 	work_unit_requests.erase(work_unit_requests.begin() + index);
 	work_units.erase(work_units.begin() + index);
+	shift_transfers_after(models_in_transfer, index);
+	shift_transfers_after(best_assignments_in_transfer, index);
 	transfer_sizes.erase(transfer_sizes.begin() + index);
 	worker_comm_buffers.erase(worker_comm_buffers.begin() + index);
 
@@ -405,6 +545,10 @@ void process_worker_cmd(int index, MPI_Status &status) {
 			process_w2s_FOUND_SOLUTION(index, status);
 			break;
 
+		case W2S::SEND_MODEL:
+			process_w2s_SEND_MODEL(index, status);
+			break;
+
 		case W2S::DISCONNECT:
 			process_w2s_DISCONNECT(index, status);
 			return;
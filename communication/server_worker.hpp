@@ -57,7 +57,8 @@ namespace W2S {
 		FOUND_SOLUTION,
 		DONE_PROCESSING,
 		GET_INSTANCES,
-		DISCONNECT
+		DISCONNECT,
+		SEND_MODEL
 	};
 
 	typedef req_max_transfer_size<REQ_MAX_CMD_LENGTH> req_max_transfer_size;
@@ -77,6 +78,7 @@ namespace W2S {
 	#include "cmd/w2s_done_processing.hpp"
 	#include "cmd/w2s_get_instances.hpp"
 	#include "cmd/w2s_disconnect.hpp"
+	#include "cmd/w2s_send_model.hpp"
 }
 
 static_assert((int) W2S::REQ_MAX_CMD_LENGTH == (int) S2W::REQ_MAX_CMD_LENGTH);
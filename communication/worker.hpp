@@ -8,9 +8,44 @@
 #define BUILD_WORKER 1
 #include "cmd/ws_typedefs.hpp"
 #include "server_worker.hpp"
+#include "model_transfer.hpp"
 #include "../worker_task.hpp"
 
 
+// first index into get_pinning_order() for the threads of this worker or -1 if its threads aren't pinned.
+// Only workers bound to a part of the cpus are pinned (see is_affinity_restricted), so unbound workers of a node
+// don't stack their threads on the same cpus. Workers of the node with the same cpus (spawned together, so they are
+// in MPI_COMM_WORLD) get consecutive cpus, if their threads don't fit none of them is pinned.
+// Collective operation of all workers in MPI_COMM_WORLD
+long get_first_pinned_cpu(const std::size_t num_threads, const std::size_t num_cpus) {
+	MPI_Comm node_comm;
+	MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm);
+	int node_rank = 0, node_size = 1;
+	MPI_Comm_rank(node_comm, &node_rank);
+	MPI_Comm_size(node_comm, &node_size);
+
+	cpu_set_t mask;
+	CPU_ZERO(&mask);
+	sched_getaffinity(0, sizeof(mask), &mask);
+	std::vector<cpu_set_t> masks(node_size);
+	MPI_Allgather(&mask, sizeof(mask), MPI_BYTE, masks.data(), sizeof(mask), MPI_BYTE, node_comm);
+	MPI_Comm_free(&node_comm);
+
+	std::size_t index = 0, num_sharing = 0; // among the workers with the same cpus
+	for (int rank = 0; rank < node_size; rank++) {
+		if (CPU_EQUAL(&mask, &masks[rank])) {
+			index += (rank < node_rank) ? 1 : 0;
+			num_sharing++;
+		}
+	}
+
+	if (!is_affinity_restricted() || (num_sharing * num_threads > num_cpus)) {
+		return -1;
+	}
+	return index * num_threads;
+}
+
+
 void process_s2w_send_instances(MPI_Status &status) {
 	S2W::send_instances si_cmd;
 	si_cmd.process(status);
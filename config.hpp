@@ -21,8 +21,8 @@
 // implementation/performance:
 
 // wheter to use a bitfield to store the current cnf formula assignment
-#define USE_BITFIELD 0
-// affects mainly memory usage
+#define USE_BITFIELD 1
+// affects mainly memory usage, allows word wise access (hashing, hamming distance)
 
 // wheter to cache the critical literal in a clause
 #define USE_CRIT_LITERAL_CACHING 1
@@ -32,6 +32,59 @@
 #define USE_CONT_DATASTRUCT 1
 // performance
 
+// wheter to store the literals of all clauses in one continuous array
+#define USE_FLAT_CLAUSE_STORAGE 1
+// performance
+
+// wheter to store offsets, break count and value of a variable in one record
+// requires USE_CONT_DATASTRUCT, may be set by the compiler (see benchmark_interleaved)
+#ifndef USE_INTERLEAVED_VAR_STATE
+#define USE_INTERLEAVED_VAR_STATE 0
+#endif
+// performance, depends on the formula
+
+// wheter to store unsat list location / satisfied literal count and critical literal of a clause in one record
+// requires USE_CRIT_LITERAL_CACHING, may be set by the compiler (see benchmark_packed)
+#ifndef USE_PACKED_CLAUSE_STATE
+#define USE_PACKED_CLAUSE_STATE 0
+#endif
+// performance
+
+// wheter to evaluate the probability function for the literals of wide clauses with AVX2 / AVX-512
+// the instruction set is chosen at runtime, requires caching and USE_PROB_FUNC_TABLE, not used with USE_INTERLEAVED_VAR_STATE
+// disabled by default, no speedup over the scalar loop was measured yet (e.g. 7-SAT on an AVX-512 cpu)
+#define USE_SIMD_BREAK_EVAL 0
+// performance, only for clauses with at least SIMD_BREAK_EVAL_MIN_WIDTH literals
+#define SIMD_BREAK_EVAL_MIN_WIDTH 4
+
+// wheter to remember the assignment with the least unsatisfied clauses (e.g. if max. flips are reached)
+// only the variables flipped since the best assignment are recorded, not the whole assignment
+#define TRACK_BEST_ASSIGNMENT 1
+
+// number of flips between two checks of the termination conditions (max. flips, stop request)
+#define FLIP_BATCH_SIZE 4096
+// performance
+
+// parse large DIMACS files with several threads (chunks of lines, parallel occurrence index),
+// requires USE_FLAT_CLAUSE_STORAGE and USE_CONT_DATASTRUCT, the formula is the same as with one thread,
+// the worker uses only one thread with USE_FIX_CNF_GLOBAL_INPUT_READING
+#define USE_PARALLEL_PARSING 1
+// smaller files are parsed by one thread
+#define PARALLEL_PARSING_MIN_BYTES (8 << 20)
+// performance, for the import of large formulas
+
+// wheter gzip (zlib), xz (liblzma) and zstd compressed formulas can be read, they are recognized by their magic bytes
+// and decompressed by a separate thread while parsing, set by the compiler if the library was found (see CMakeLists.txt)
+#ifndef USE_ZLIB
+#define USE_ZLIB 0
+#endif
+#ifndef USE_LZMA
+#define USE_LZMA 0
+#endif
+#ifndef USE_ZSTD
+#define USE_ZSTD 0
+#endif
+
 // wheter a literal may appear multiple times in a clause
 // not fully compatible with caching, use carefully
 #define ALLOW_UNCLEAN_CLAUSES 0
@@ -42,17 +95,46 @@
 
 // implementation/performance:
 
-// number of probsat threads per worker, was 12 on bwUniCluster
-#define NUM_PROBSAT_THREADS_PER_WORKER 2
+// default number of probsat threads per worker (was 12 on bwUniCluster), can be changed by the worker parameter --threads,
+// 0: the cpus the worker may use (affinity mask, limited by the cpu quota of its cgroup, see util/numa.hpp)
+#define NUM_PROBSAT_THREADS_PER_WORKER 0
+
+// wheter the probsat threads of a worker are bound to the cpus of its affinity mask, spread over the NUMA nodes
+// (see util/numa.hpp), can be disabled by the worker parameter --noThreadPinning.
+// Only workers bound to a part of the cpus (e.g. mpirun --bind-to, taskset) are pinned, workers of one spawn with
+// the same cpus get different ones (see get_first_pinned_cpu), workers of other spawns on the node aren't known
+#define USE_THREAD_PINNING 1
+// performance not measured yet, benchmark --scaling hasn't been run on a NUMA machine
+
+// wheter every NUMA node of a worker gets its own copy of a formula and its probability table, written by a thread
+// on that node (first touch), requires USE_CNF_MULTITHREAD_SHARING and USE_THREAD_PINNING, only used if the worker
+// spans several nodes and its threads are pinned (otherwise they may run on any node and share one formula)
+#define USE_NUMA_REPLICATION 1
+// memory usage (and the share of the formula cache) grows with the number of nodes, performance not measured yet (see above)
 
 // usage of shared memory for cnf formula
 #define USE_CNF_MULTITHREAD_SHARING 1
 
+// budget in MiB of the per worker cache of loaded formulas (LRU, requires USE_CNF_MULTITHREAD_SHARING)
+// jobs of a file that was loaded before reuse the formula, can be changed by the worker parameter --formulaCache
+#define FORMULA_CACHE_SIZE_MB 1024
+// performance, if the server hands out the same file repeatedly
+
+// directory (shared memory) for the formulas which are shared by all worker processes of a node,
+// the first worker converts a formula into the binary format there (subdirectory probsat-<uid>, only accessible by the user)
+// and all workers map it read only (images of killed workers are removed by the next one),
+// an empty string disables the sharing, can be changed by the worker parameter --sharedFormulaDir
+#define SHARED_FORMULA_DIRECTORY "/dev/shm"
+// memory, if several worker processes run on a node (requires USE_FLAT_CLAUSE_STORAGE and USE_CONT_DATASTRUCT)
+
 // bugfixes:
 
 // if USE_CNF_MULTITHREAD_SHARING is enabled, this fix might be required
 // so that the data is loaded from the main thread as memory allocations
 // dont work as expected (& specified!) over multiple threads... bad for performance!
+// With the fix the worker loads the formulas of a job in create_tasks (main thread), also the copy of every task
+// without USE_CNF_MULTITHREAD_SHARING, otherwise each task loads its formula in its own thread.
+// The worker parses with one thread then and the main thread writes the copies of USE_NUMA_REPLICATION
 #define USE_FIX_CNF_GLOBAL_INPUT_READING 1
 // enable if you get Segmentation fault becauso of Address not mapped, like this:
 // [BPC:10798] *** Process received signal ***
@@ -69,6 +151,11 @@
 // unperformant fix for deadlock in OpenMPI when multiple connection attempts on one port happen simultaneos
 #define MAX_SIMULTANEOUS_CONNECTION_ATTEMPTS 1
 
+// precompute the probability function once per formula and share the table between all threads
+// (takes precedence over USE_CACHED_PROB_FUNC)
+#define USE_PROB_FUNC_TABLE 1
+// performance
+
 #define USE_CACHED_PROB_FUNC 0
 #define USE_PROB_FUNC_LOCAL_CACHE 0
 
@@ -29,6 +29,7 @@ void cmd_help(std::vector<std::string> &args) {
 	std::cout << "\thelp (shows this message)" << std::endl;
 	std::cout << "\tadd_workers <num_workers> [hostfile] [worker arguments ...]" << std::endl;
 	std::cout << "\t\t one may use >>use_no_hostfile<< as placeholder for the hostfile" << std::endl;
+	std::cout << "\t\t e.g. >>--threads <n><< as worker argument, default: one probsat thread per cpu available to the worker, at most 4 per cpu" << std::endl;
 	std::cout << "\tadd_file <anzahl_startbelegungen> <anzahl_flips> formula.cnf" << std::endl;
 	std::cout << "\twait_for_server" << std::endl;
 	std::cout << "\texit" << std::endl;
@@ -1,6 +1,82 @@
 
 #include "probsat.hpp"
 
+// runs the iterations on a formula with the types chosen by load_cnf_formula
+template<class formula_t>
+void solve(const formula_t &bformula) {
+	using num_t = typename formula_t::num_type;
+	using instance_t = serial_instance_t<formula_t>;
+
+	// prob_func_t pfi = poly_prob_func_t<num_t>();
+	prob_func_t<num_t> pfi = prob_func_t<num_t>(poly_prob_func_t<num_t>(eps, cb), bformula.get_max_num_breaks_possible());
+
+	auto belegung = typename instance_t::configuration_type(bformula.num_vars());
+
+	for (std::size_t it = 1; it <= num_iterations; it++) {
+		random_generator_t rgen = random_generator_t(seed);
+		
+		std::cout << "c iteration " << it << " / " << num_iterations << std::endl;
+		std::cout << "c seed = " << std::to_string(rgen.get_seed()) << std::endl;
+
+		do_init_configuration(bformula, belegung, rgen);			
+		instance_t solver = instance_t(bformula, pfi, belegung, rgen);
+		
+		auto start_solving = std::chrono::high_resolution_clock::now();
+		
+		while (!solver.found_solution()) {
+			if ((0 < max_flips) && (max_flips <= solver.get_num_flips())) {
+				std::cout << "c FOUND NO SOLUTION AFTER " << solver.get_num_flips() << " FLIPS!" << std::endl;
+				break;
+			}
+
+			std::size_t batch_size = FLIP_BATCH_SIZE;
+			if (0 < max_flips) {
+				batch_size = std::min<std::size_t>(batch_size, max_flips - solver.get_num_flips());
+			}
+			solver.do_flips(batch_size);
+		}
+		
+		auto done_solving = std::chrono::high_resolution_clock::now();
+		auto duration = std::chrono::duration_cast<std::chrono::microseconds>(done_solving - start_solving).count();
+		
+		auto num_flips = solver.get_num_flips();
+		double fps = ((float) num_flips) / duration * 1000000.;
+		double fpv = ((float) num_flips) / bformula.num_vars();
+		double fpc = ((float) num_flips) / bformula.num_clauses();
+		
+		std::cout << "c done after " << num_flips << " flips and " << round(duration/1000.) << " milliseconds" << std::endl;
+		std::cout << "c => " << round(fps) << " flips per seconds" << std::endl;
+		std::cout << "c => " << fpv << " flips per variable" << std::endl;
+		std::cout << "c => " << fpc << " flips per clause" << std::endl;
+		
+		if (solver.found_solution()) {
+			assert(solver.check_assignment());
+			std::cout << "s SATISFIABLE" << std::endl;
+
+			if (0 < output_solution) {
+				const auto &assignment = solver.get_assignment();
+				for (num_t i = 0; i < bformula.num_vars(); i++) {
+					if (0 == i % output_solution) {
+						if (0 < i) {
+							std::cout << std::endl;
+						}
+
+						std::cout << "v";
+					}
+
+					std::cout << " " << (assignment[i] ? (i+1) : -(i+1));
+				}
+				
+				std::cout << std::endl;
+			}
+
+			break;
+		}
+		
+		seed = random_generator_t().get_seed();
+	}
+}
+
 int main(int argc, char **argv)
 {
 	auto start = std::chrono::high_resolution_clock::now();
@@ -45,80 +121,21 @@ int main(int argc, char **argv)
 		std::string fname = argv[argc - 1];
 
 		std::cout << "c processing: " << fname << std::endl;
-		cnf_formula_t bformula = cnf_formula_t(fname);
-		std::cout << "c num vars = " << std::to_string(bformula.num_vars()) << std::endl;
-		std::cout << "c clauses = " << std::to_string(bformula.num_clauses()) << std::endl;
-
-		// prob_func_t pfi = poly_prob_func_t();
-		prob_func_t pfi = prob_func_t(poly_prob_func_t(eps, cb));
-		std::cout << "c algorithm: polynomial with eps = " << std::to_string(eps)
-			<< " and cb = " << std::to_string(cb) << std::endl;
-		
-		auto belegung = serial_instance_t::configuration_type(bformula.num_vars());
-
-		auto imported = std::chrono::high_resolution_clock::now();
-		auto import_duration = std::chrono::duration_cast<std::chrono::milliseconds>(imported - start);
-		std::cout << "c import duration: " << import_duration.count() << " ms" << std::endl;
-
-
-		for (std::size_t it = 1; it <= num_iterations; it++) {
-			random_generator_t rgen = random_generator_t(seed);
-			
-			std::cout << "c iteration " << it << " / " << num_iterations << std::endl;
-			std::cout << "c seed = " << std::to_string(rgen.get_seed()) << std::endl;
-
-			do_init_configuration(bformula, belegung, rgen);			
-			serial_instance_t solver = serial_instance_t(bformula, pfi, belegung, rgen);
-			
-			auto start_solving = std::chrono::high_resolution_clock::now();
-			
-			while (!solver.found_solution()) {
-				solver.do_flip();
-				
-				if ((0 < max_flips) && (max_flips <= solver.get_num_flips())) {
-					std::cout << "c FOUND NO SOLUTION AFTER " << solver.get_num_flips() << " FLIPS!" << std::endl;
-					break;
-				}
-			}
-			
-			auto done_solving = std::chrono::high_resolution_clock::now();
-			auto duration = std::chrono::duration_cast<std::chrono::microseconds>(done_solving - start_solving).count();
-			
-			auto num_flips = solver.get_num_flips();
-			double fps = ((float) num_flips) / duration * 1000000.;
-			double fpv = ((float) num_flips) / bformula.num_vars();
-			double fpc = ((float) num_flips) / bformula.num_clauses();
-			
-			std::cout << "c done after " << num_flips << " flips and " << round(duration/1000.) << " milliseconds" << std::endl;
-			std::cout << "c => " << round(fps) << " flips per seconds" << std::endl;
-			std::cout << "c => " << fpv << " flips per variable" << std::endl;
-			std::cout << "c => " << fpc << " flips per clause" << std::endl;
-			
-			if (solver.found_solution()) {
-				assert(solver.check_assignment());
-				std::cout << "s SATISFIABLE" << std::endl;
-
-				if (0 < output_solution) {
-					for (auto i = 0; i < bformula.num_vars(); i++) {
-						if (0 == i % output_solution) {
-							if (0 < i) {
-								std::cout << std::endl;
-							}
-
-							std::cout << "v";
-						}
+		load_cnf_formula(fname, [&](const auto bformula_sptr) {
+			const auto &bformula = *bformula_sptr;
+			std::cout << "c num vars = " << std::to_string(bformula.num_vars()) << std::endl;
+			std::cout << "c clauses = " << std::to_string(bformula.num_clauses()) << std::endl;
+			std::cout << "c data types: " << describe_types(bformula) << std::endl;
 
-						std::cout << " " << (belegung[i] ? i : -i);
-					}
-					
-					std::cout << std::endl;
-				}
+			std::cout << "c algorithm: polynomial with eps = " << std::to_string(eps)
+				<< " and cb = " << std::to_string(cb) << std::endl;
 
-				break;
-			}
-			
-			seed = random_generator_t().get_seed();
-		}
+			auto imported = std::chrono::high_resolution_clock::now();
+			auto import_duration = std::chrono::duration_cast<std::chrono::milliseconds>(imported - start);
+			std::cout << "c import duration: " << import_duration.count() << " ms" << std::endl;
+
+			solve(bformula);
+		});
 	} catch (const std::exception& ex) {
 		print_exception("main", ex);
 	}
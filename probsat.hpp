@@ -7,11 +7,12 @@
 
 #include "util/util.hpp"
 #include "util/parse_params.hpp"
-#include "sat/3sat-clause.hpp"
 #include "sat/instance.hpp"
+#include "sat/dispatch.hpp"
 #include "sat/probability_functions/polynomial.hpp"
 #include "sat/probability_functions/exponential.hpp"
 #include "sat/probability_functions/cached.hpp"
+#include "sat/probability_functions/table.hpp"
 
 #include <chrono>
 #include <cmath>
@@ -27,34 +28,29 @@ constexpr bool manythreads = true;
 
 
 // data type specialications:
-using num_t = int32_t;
-using sum_t = int32_t;
-using cnt_t = int16_t;
+// num_t, sum_t, cnt_t and the clause type are chosen per formula by load_cnf_formula (sat/dispatch.hpp)
 using prec_t = double;
 
-
-#define USE_ONLY_3SAT_CLAUSES 0
-
-#if USE_ONLY_3SAT_CLAUSES
-	#include "sat/3sat-clause.hpp"
-	using clause_t = static_clause_3sat<num_t, 4>;
-#else
-	#include "sat/clause.hpp"
-	using clause_t = generic_clause<num_t>;
-#endif
-
-using cnf_formula_t = cnf_formula<num_t, sum_t, cnt_t, clause_t>;
-
+template<typename num_t>
 using poly_prob_func_t = prob_func_polynomial<num_t, prec_t>;
+template<typename num_t>
 using exp_prob_func_t = prob_func_exponential<num_t, prec_t>;
 
-using prob_func_t = prob_func_cached<num_t, prec_t, poly_prob_func_t, multithreaded, manythreads>;
+template<typename num_t>
+using prob_func_t = prob_func_table<num_t, prec_t, poly_prob_func_t<num_t>>;
+// alternative with lazy caching:
+// template<typename num_t>
+// using prob_func_t = prob_func_cached<num_t, prec_t, poly_prob_func_t<num_t>, multithreaded, manythreads>;
 // alternative without caching:
-// using prob_func_t = poly_prob_func_t;
+// template<typename num_t>
+// using prob_func_t = poly_prob_func_t<num_t>;
 
 // using random_generator_t = random_generator;
 using random_generator_t = lin_cong_random_generator;
-using serial_instance_t = serial_instance<num_t, sum_t, cnt_t, prec_t, clause_t, prob_func_t, random_generator_t, caching>;
+
+template<class formula_t>
+using serial_instance_t = serial_instance<typename formula_t::num_type, typename formula_t::sum_type, typename formula_t::cnt_type,
+	prec_t, typename formula_t::clause_type, prob_func_t<typename formula_t::num_type>, random_generator_t, caching>;
 
 
 std::size_t num_iterations = 1;
@@ -65,8 +61,9 @@ prec_t cb = 2.06;
 std::size_t output_solution = 0;
 
 
-void do_init_configuration(const cnf_formula_t &bformula, serial_instance_t::configuration_type &belegung, random_generator_t &rgen) {
-	for (num_t i = 0; i < bformula.num_vars(); i++) {belegung[i] = rgen.rand() % 2;}
+template<class formula_t, class configuration_t>
+void do_init_configuration(const formula_t &bformula, configuration_t &belegung, random_generator_t &rgen) {
+	for (typename formula_t::num_type i = 0; i < bformula.num_vars(); i++) {belegung[i] = rgen.rand() % 2;}
 }
 
 void parse_param_help(std::queue<std::string> &params) {
@@ -1,79 +1,70 @@
 #ifndef THREE_SAT_CLAUSE_HPP
 #define THREE_SAT_CLAUSE_HPP
 
-// Datenstrukturen zur Repräsentation von 3-SAT Klauseln (optimierte Darstellung)
+// Datenstrukturen zur Repräsentation von k-SAT Klauseln mit fester Länge (optimierte Darstellung)
 
 #include "clause.hpp"
 
-template<typename num_t, uint8_t align_border>
-class static_clause_3sat {
+// clause with exactly K literals, the view has a static width so loops over the literals are unrolled
+template<typename num_t, std::size_t K>
+class static_clause_k {
 	private:
-		num_t clause[3];
-
-		// add padding to align array of static_clause_3sat to align_border in bytes
-		static constexpr std::size_t alignment = ((align_border - ((3*sizeof(clause)) % align_border)) % align_border);
-		const uint8_t padding[alignment];
+		num_t clause[K];
 
 	public:
 		using num_type = num_t;
+		using view_type = clause_view<num_t, K>;
 		static constexpr bool is_clause_t = true;
+		static constexpr std::size_t width = K;
+
+		static_assert(0 < K);
 
 		// constructor
-		static_clause_3sat() : clause{}, padding{} {}
+		static_clause_k() : clause{} {}
 
 		template<typename Iterator>
-		static_clause_3sat(Iterator it1, Iterator it2, std::size_t num_vars) : clause{}, padding{}
+		static_clause_k(Iterator it1, Iterator it2, std::size_t num_vars) : clause{}
 		{
 			#if VERIFY_INPUT || DEBUG_ASSERTIONS
-			if (3 != num_vars) {
-				throw std::runtime_error("a 3-sat clause is expected, number of variables doesn't match");
+			if (K != num_vars) {
+				throw std::runtime_error("a " + std::to_string(K) + "-sat clause is expected, number of variables doesn't match");
 			}
 			#endif
 
 			ignore(it2, num_vars);
-			
+
 			auto it = it1;
-			for (std::size_t i = 0; i < 3; i++) {
+			for (std::size_t i = 0; i < K; i++) {
 				clause[i] = *it;
 				it++;
 			}
 		}
-		
-		// delete copy constructor
-		static_clause_3sat(const static_clause_3sat &other) :
-			clause{other.clause[0], other.clause[1], other.clause[2]}, padding{} {}
-
-		// copy & swap idiom
-        friend void swap(static_clause_3sat &a, static_clause_3sat &b)
-			noexcept(std::is_nothrow_swappable_v<num_t>)
-		{
-			static_assert(a.alignment == b.alignment);
-			std::swap(a.clause[0], b.clause[0]);
-			std::swap(a.clause[1], b.clause[1]);
-			std::swap(a.clause[2], b.clause[2]);
-        }
-
-        static_clause_3sat(static_clause_3sat &&other) : static_clause_3sat() {
-            swap(*this, other);
-        }
 
-        static_clause_3sat& operator=(static_clause_3sat other) {
-            swap(*this, other);
-            return *this;
-        }
+		// trivially copyable
+		static_clause_k(const static_clause_k &other) = default;
+		static_clause_k& operator=(const static_clause_k &other) = default;
 
 		// basic clause operations
 		inline num_t& operator[](const uint8_t index) {
 			return clause[index];
 		}
-		
+
 		inline const num_t& operator[](const uint8_t index) const {
 			return clause[index];
 		}
-		
-		static uint8_t num_vars() {
-			return 3;
+
+		static constexpr std::size_t num_vars() {
+			return K;
+		}
+
+		view_type view() const {
+			return view_type(clause, K);
 		}
 };
 
+// the former padding to align_border bytes made the clause non assignable and is dropped,
+// an array of static_clause_k<int32_t, 3> is 4 byte aligned anyway
+template<typename num_t, uint8_t align_border = sizeof(num_t)>
+using static_clause_3sat = static_clause_k<num_t, 3>;
+
 #endif
@@ -0,0 +1,162 @@
+#ifndef BINARY_FORMULA_HPP
+#define BINARY_FORMULA_HPP
+
+// Binärformat für eingelesene Formeln, die Arrays liegen so in der Datei wie in cnf_formula und werden eingeblendet (mmap)
+
+#include "../util/mapped_file.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <utility>
+
+
+// file layout, all integers in the byte order of the machine that wrote the file:
+//   header, literals of all clauses, clause offsets (only for clauses without static width),
+//   occurrence offsets (std::pair<sum_t, cnt_t> per variable and one more), occurrence lists
+// every array starts at a multiple of binary_formula_alignment bytes
+struct binary_formula_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order; // binary_formula_byte_order as written
+	uint32_t num_size; // sizeof(num_t)
+	uint32_t sum_size;
+	uint32_t cnt_size;
+	uint32_t occurrence_record_size; // sizeof(std::pair<sum_t, cnt_t>)
+	uint64_t static_width; // width of every clause if the clause type has a static width, otherwise 0
+	uint64_t num_vars;
+	uint64_t num_clauses;
+	uint64_t num_literals;
+	uint64_t num_occurrences; // length of the occurrence lists
+	uint64_t max_num_breaks_possible;
+	uint64_t max_clause_width;
+	uint64_t uniform_clause_width;
+	// byte positions of the arrays
+	uint64_t literals_pos;
+	uint64_t offsets_pos; // num_clauses + 1 entries of sum_t, 0 if static_width
+	uint64_t occurrence_offset_pos;
+	uint64_t clauses_with_vars_pos;
+	uint64_t file_size;
+};
+
+constexpr const char binary_formula_magic[8] = {'P', 'S', 'A', 'T', 'B', 'I', 'N', '\0'};
+constexpr uint32_t binary_formula_version = 1;
+constexpr uint32_t binary_formula_byte_order = 0x01020304;
+constexpr std::size_t binary_formula_alignment = 64;
+
+// checks the magic bytes at the beginning of the file, so DIMACS and binary files can be passed alike
+bool is_binary_formula(const std::string &filename);
+
+// header of a mapped binary formula, throws if the file isn't a valid binary formula of this version and byte order
+const binary_formula_header& get_binary_formula_header(const mapped_file &image);
+
+// n elements of type T at byte position pos, throws if they aren't in the file or misaligned
+template<typename T>
+const T* get_binary_formula_array(const mapped_file &image, const uint64_t pos, const uint64_t n);
+
+// writes n elements at the next aligned position and returns it
+template<typename T>
+uint64_t write_binary_formula_array(std::ostream &os, uint64_t &pos, const T *data, const uint64_t n);
+
+// like write_binary_formula_array, but the padding bytes of the records are written as zeros
+// (they are uninitialized in memory), so the file only depends on the values
+template<typename first_t, typename second_t>
+uint64_t write_binary_formula_pairs(std::ostream &os, uint64_t &pos, const std::pair<first_t, second_t> *data, const uint64_t n);
+
+
+// *********************************************************************
+// Implementation:
+// *********************************************************************
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+
+inline bool is_binary_formula(const std::string &filename) {
+	std::ifstream filehandle(filename, std::ios::binary);
+	char magic[sizeof(binary_formula_magic)] = {};
+	filehandle.read(magic, sizeof(magic));
+	return filehandle && (0 == std::memcmp(magic, binary_formula_magic, sizeof(magic)));
+}
+
+
+inline const binary_formula_header& get_binary_formula_header(const mapped_file &image) {
+	if (image.size() < sizeof(binary_formula_header)) {
+		throw std::runtime_error("invalid binary formula '" + image.name() + "': file is too small");
+	}
+
+	const binary_formula_header &header = *((const binary_formula_header*) image.data());
+
+	if (0 != std::memcmp(header.magic, binary_formula_magic, sizeof(binary_formula_magic))) {
+		throw std::runtime_error("'" + image.name() + "' is no binary formula");
+	}
+	if (binary_formula_version != header.version) {
+		throw std::runtime_error("binary formula '" + image.name() + "' has version " + std::to_string(header.version)
+			+ ", expected " + std::to_string(binary_formula_version) + " (convert it again)");
+	}
+	if (binary_formula_byte_order != header.byte_order) {
+		throw std::runtime_error("binary formula '" + image.name() + "' was written with another byte order");
+	}
+	if (image.size() != header.file_size) {
+		throw std::runtime_error("binary formula '" + image.name() + "' is truncated");
+	}
+
+	return header;
+}
+
+
+template<typename T>
+const T* get_binary_formula_array(const mapped_file &image, const uint64_t pos, const uint64_t n) {
+	if ((0 != pos % alignof(T)) || (pos > image.size()) || (n > (image.size() - pos) / sizeof(T))) {
+		throw std::runtime_error("invalid binary formula '" + image.name() + "': array at byte "
+			+ std::to_string(pos) + " is out of range");
+	}
+
+	return (const T*) (image.data() + pos);
+}
+
+
+template<typename T>
+uint64_t write_binary_formula_array(std::ostream &os, uint64_t &pos, const T *data, const uint64_t n) {
+	static const char padding[binary_formula_alignment] = {};
+
+	const uint64_t padded = (pos + binary_formula_alignment - 1) / binary_formula_alignment * binary_formula_alignment;
+	os.write(padding, padded - pos);
+	os.write((const char*) data, n * sizeof(T));
+
+	pos = padded + n * sizeof(T);
+	return padded;
+}
+
+
+template<typename first_t, typename second_t>
+uint64_t write_binary_formula_pairs(std::ostream &os, uint64_t &pos, const std::pair<first_t, second_t> *data, const uint64_t n) {
+	using record_t = std::pair<first_t, second_t>;
+	constexpr std::size_t block_size = 1 << 16; // records
+
+	const record_t sample;
+	const std::size_t first_pos = (const char*) &sample.first - (const char*) &sample;
+	const std::size_t second_pos = (const char*) &sample.second - (const char*) &sample;
+
+	const uint64_t start = write_binary_formula_array(os, pos, data, 0);
+
+	std::vector<char> block;
+	for (uint64_t i = 0; i < n; i += block_size) {
+		const std::size_t count = std::min<uint64_t>(block_size, n - i);
+		block.assign(count * sizeof(record_t), 0);
+		for (std::size_t j = 0; j < count; j++) {
+			std::memcpy(&block[j * sizeof(record_t) + first_pos], &data[i + j].first, sizeof(first_t));
+			std::memcpy(&block[j * sizeof(record_t) + second_pos], &data[i + j].second, sizeof(second_t));
+		}
+		os.write(block.data(), block.size());
+	}
+
+	pos = start + n * sizeof(record_t);
+	return start;
+}
+
+#endif
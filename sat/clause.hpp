@@ -6,11 +6,76 @@
 #include <istream>
 #include <string>
 #include <vector>
+#include <limits>
+#include <stdexcept>
 #include <cassert>
+#include <utility>
+#include <memory>
 
+#include "../util/mappable_vector.hpp"
 #include "../util/util.hpp"
 
 
+// non owning view on the literals of a clause (pointer + length), no copies required
+// if width is greater zero the number of literals is known at compile time
+template<typename num_t, std::size_t width = 0>
+class clause_view {
+	private:
+		const num_t *literals;
+		std::size_t length;
+
+		template<typename F, std::size_t... I>
+		static inline bool for_each_index_unrolled(F &f, std::index_sequence<I...>) {
+			return (f(I) && ...);
+		}
+
+	public:
+		using num_type = num_t;
+		static constexpr bool is_clause_t = true;
+		static constexpr std::size_t static_width = width;
+
+		clause_view(const num_t *lits, std::size_t num_lits) : literals(lits), length(num_lits) {
+			assert((0 == width) || (width == num_lits));
+		}
+
+		inline const num_t& operator[](const std::size_t index) const {
+			return literals[index];
+		}
+
+		inline std::size_t num_vars() const {
+			if constexpr (0 < width) {
+				return width;
+			} else {
+				return length;
+			}
+		}
+
+		inline const num_t* begin() const {
+			return literals;
+		}
+
+		inline const num_t* end() const {
+			return literals + num_vars();
+		}
+
+		// calls f(i) for i = 0, 1, ... until f returns false, returns false if aborted
+		// if the width is known at compile time the loop is completely unrolled
+		template<typename F>
+		inline bool for_each_index(F &&f) const {
+			if constexpr (0 < width) {
+				return for_each_index_unrolled(f, std::make_index_sequence<width>());
+			} else {
+				for (std::size_t i = 0; i < length; i++) {
+					if (!f(i)) {
+						return false;
+					}
+				}
+				return true;
+			}
+		}
+};
+
+
 template<typename num_t>
 class generic_clause {
 	private:
@@ -18,6 +83,7 @@ class generic_clause {
 
 	public:
 		using num_type = num_t;
+		using view_type = clause_view<num_t>;
 		static constexpr bool is_clause_t = true;
 
 		// constructor
@@ -65,8 +131,129 @@ class generic_clause {
 		std::size_t num_vars() const {
 			return clause.size();
 		}
+
+		view_type view() const {
+			return view_type(clause.data(), clause.size());
+		}
 };
 
+// stores all clauses back to back in one continuous array (compressed row storage)
+// clause i consists of literals[offsets[i], offsets[i+1]), for a fixed width no offsets are stored
+template<typename num_t, typename sum_t, std::size_t width = 0>
+class flat_clause_storage {
+	private:
+		mappable_vector<num_t> literals; // Literale aller Klauseln direkt hintereinander
+		mappable_vector<sum_t> offsets; // offset der Klausel in literals, letzter Eintrag ist Anzahl aller Literale
+		std::size_t count = 0;
+
+	public:
+		using view_type = clause_view<num_t, width>;
+		using sum_type = sum_t;
+
+		flat_clause_storage() : literals(), offsets({0}) {}
+
+		void clear() {
+			literals.clear();
+			offsets.assign(1, 0);
+			count = 0;
+		}
+
+		void reserve(std::size_t num_clauses) {
+			literals.reserve(num_clauses * ((0 < width) ? width : 3));
+			if constexpr (0 == width) {
+				offsets.reserve(num_clauses + 1);
+			}
+		}
+
+		template<typename other_clause_t>
+		void push_back(const other_clause_t &clause) {
+			const std::size_t n = clause.num_vars();
+
+			#if VERIFY_INPUT
+				if ((0 < width) && (width != n)) {
+					throw std::runtime_error("flat_clause_storage: clause width doesn't match");
+				}
+			#endif
+
+			for (std::size_t i = 0; i < n; i++) {
+				literals.push_back(clause[i]);
+			}
+
+			if constexpr (0 == width) {
+				#if VERIFY_INPUT
+					if (literals.size() > (std::size_t) std::numeric_limits<sum_t>::max()) {
+						throw std::out_of_range("flat_clause_storage: sum_t is too small!");
+					}
+				#endif
+				offsets.push_back(literals.size());
+			}
+
+			count++;
+		}
+
+		inline std::size_t size() const {
+			return count;
+		}
+
+		// raw arrays, e.g. to write the formula in binary format (offsets is {0} for a static width)
+		const mappable_vector<num_t>& get_literals() const {
+			return literals;
+		}
+
+		const mappable_vector<sum_t>& get_offsets() const {
+			return offsets;
+		}
+
+		// uses mapped arrays without copying them (see binary_formula.hpp), offs is ignored for a static width
+		void map(const std::shared_ptr<const void> &image, const num_t *lits, const std::size_t num_lits,
+			const sum_t *offs, const std::size_t num_clauses)
+		{
+			literals.map(image, lits, num_lits);
+			if constexpr (0 == width) {
+				offsets.map(image, offs, num_clauses + 1);
+			}
+			count = num_clauses;
+		}
+
+		// copies mapped arrays into owned memory
+		void unmap() {
+			literals.unmap();
+			offsets.unmap();
+		}
+
+		// takes over all clauses at once, e.g. from the parallel parser, offs has num_clauses + 1 entries
+		// (the last one is the number of literals) and is only checked for a static width
+		void assign(std::vector<num_t> &&lits, std::vector<sum_t> &&offs) {
+			const std::size_t num_clauses = offs.size() - 1;
+
+			if constexpr (0 < width) {
+				#if VERIFY_INPUT
+					for (std::size_t i = 0; i < num_clauses; i++) {
+						if (width != (std::size_t) (offs[i+1] - offs[i])) {
+							throw std::runtime_error("flat_clause_storage: clause width doesn't match");
+						}
+					}
+				#endif
+				offsets.assign(1, 0);
+			} else {
+				offsets.assign(std::move(offs));
+			}
+
+			literals.assign(std::move(lits));
+			count = num_clauses;
+		}
+
+		inline view_type operator[](const std::size_t index) const {
+			if constexpr (0 < width) {
+				return view_type(literals.data() + index * width, width);
+			} else {
+				const sum_t offset = offsets[index];
+				return view_type(literals.data() + offset, offsets[index+1] - offset);
+			}
+		}
+};
+
+
 #if __cplusplus > 201703L
 template<typename clause_t> requires (clause_t::is_clause_t)
 #else
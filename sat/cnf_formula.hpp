@@ -4,7 +4,11 @@
 // Datenstruktur für die Formeln und Informationen die für statisches Caching bei ProbSAT verwendet werden
 
 #include "../config.hpp"
+#include "clause.hpp"
+#include "binary_formula.hpp"
+#include "../util/mappable_vector.hpp"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -15,6 +19,7 @@
 
 // Macros used:
 // VERIFY_INPUT - check for common problems related to the input data
+// USE_FLAT_CLAUSE_STORAGE - wheter to store all clauses in one continuous array
 // USE_CONT_DATASTRUCT - wheter to use an alternative datastructure with continuous memory layout
 // ADDITIONAL_CHECKS - additional sanity checks used while developing to ensure correctness
 
@@ -47,13 +52,22 @@ class cnf_formula {
 		// cnt_t max_num_lit_occurrences = 0; // max. times a *literal* is used in clauses
 		
 		// Information pro Klausel
-		std::vector<clause_t> clauses; // Liste der Klauseln (Literale pro Klausel mit Werte +- [1,...,num_vars])
+		#if USE_FLAT_CLAUSE_STORAGE
+			// alle Literale in einem Array, die Klauseln liegen direkt hintereinander
+			flat_clause_storage<num_t, sum_t, clause_t::view_type::static_width> clauses;
+		#else
+			std::vector<clause_t> clauses; // Liste der Klauseln (Literale pro Klausel mit Werte +- [1,...,num_vars])
+		#endif
 
 
 		#if USE_CONT_DATASTRUCT
-			std::vector<std::pair<sum_t, cnt_t>> occurrence_offset; // offset in clauses_with_vars and number of negative clauses
-			std::vector<num_t> clauses_with_vars; // Liste mit Klauseln in denen die Variable als Literal vorkommt
+			mappable_vector<std::pair<sum_t, cnt_t>> occurrence_offset; // offset in clauses_with_vars and number of negative clauses
+			mappable_vector<num_t> clauses_with_vars; // Liste mit Klauseln in denen die Variable als Literal vorkommt
 			void cnf_formula_constructor_variant_cont_datastruct(std::vector<std::pair<cnt_t, cnt_t>> &count_clauses_with_vars);
+			#if USE_PARALLEL_PARSING
+				// same occurrence lists, built by num_threads threads
+				void build_occurrence_index_parallel(const std::vector<std::pair<cnt_t, cnt_t>> &count_clauses_with_vars, const unsigned num_threads);
+			#endif
 		#else
 			// Information pro Variable
 			std::vector<std::pair<std::vector<num_t>, std::vector<num_t>>> clauses_with_vars;
@@ -61,6 +75,20 @@ class cnf_formula {
 		#endif
 
 		num_t max_num_breaks_possible = 0;
+		std::size_t max_clause_width = 0;
+		std::size_t uniform_clause_width = 0; // 0 if the clauses have different widths
+		std::size_t num_literals = 0; // sum of all clause widths
+
+		void determine_clause_widths();
+
+		// other clause and integer types, required by the converting constructor
+		#if __cplusplus > 201703L
+			template<typename num_t_, typename sum_t_, typename cnt_t_, class clause_t_> requires (clause_t_::is_clause_t)
+			friend class cnf_formula;
+		#else
+			template<typename num_t_, typename sum_t_, typename cnt_t_, class clause_t_, bool a_>
+			friend class cnf_formula;
+		#endif
 
 		#if ENALBE_CNF_MULTITHREAD_SHARING
 			std::mutex init_mutex;
@@ -69,17 +97,51 @@ class cnf_formula {
 		std::string file;
 
 	public:
+		using num_type = num_t;
+		using sum_type = sum_t;
+		using cnt_type = cnt_t;
+		using clause_type = clause_t;
+		using clause_view_t = typename clause_t::view_type;
+
 		num_t num_vars() const;
 		num_t num_clauses() const;
 		num_t get_max_num_breaks_possible() const;
+		std::size_t get_max_clause_width() const;
+		std::size_t get_uniform_clause_width() const; // number of literals of every clause, 0 if not uniform
+		std::size_t get_num_literals() const;
+		std::size_t get_memory_usage() const; // estimate in bytes (clauses and occurrence lists), e.g. for caching
 		clause_t get_clause(num_t clause_index) const;
+		clause_view_t get_clause_view(num_t clause_index) const; // no copy, use this in performance critical code
 
 		auto get_iterators_for_clauses_with_vars(num_t var_index) const;
 		auto get_iterators_for_clauses_with_vars(num_t var_index);
 
+		#if USE_CONT_DATASTRUCT
+			// raw access to the occurrence lists, e.g. to copy the offsets into per variable records
+			std::pair<sum_t, cnt_t> get_occurrence_offset(num_t var_index) const; // var_index in [0, num_vars()]
+			const num_t* get_clauses_with_vars() const;
+		#endif
+
 		void initialize();
 		cnf_formula(std::string filename, const bool load = true);
 
+		#if USE_FLAT_CLAUSE_STORAGE && USE_CONT_DATASTRUCT
+			// binary format with the arrays as laid out here (see binary_formula.hpp), written by cnf2bin
+			void save_binary(const std::string &filename) const;
+
+			// uses the arrays of the mapped file directly (no parsing, no copies), the types must match the header
+			explicit cnf_formula(const std::shared_ptr<const mapped_file> &image);
+		#endif
+
+		// takes over a formula with other clause or integer types, e.g. to get a static width
+		// or narrower integers after parsing, the types must be large enough for the formula
+		template<typename other_num_t, typename other_sum_t, typename other_cnt_t, class other_clause_t>
+		explicit cnf_formula(cnf_formula<other_num_t, other_sum_t, other_cnt_t, other_clause_t> &&other);
+
+		// copy with own arrays (mapped ones are copied too) which are allocated and written by the calling thread,
+		// so the memory is local to its NUMA node (first touch), e.g. for a replica per node
+		std::shared_ptr<cnf_formula> make_local_copy() const;
+
 		void debug_output_formula() const;
 };
 
@@ -90,12 +152,19 @@ class cnf_formula {
 
 #include <tuple>
 #include <type_traits>
+#include <limits>
 
 #include "../util/util.hpp"
 #include "input.hpp"
 
 #include <fstream>
+#include <filesystem>
 #include <cstdint>
+#include <cstring>
+
+#if USE_PARALLEL_PARSING
+#include "../util/parallel.hpp"
+#endif
 
 
 #if __cplusplus > 201703L
@@ -124,10 +193,54 @@ num_t CNF_FORMULA_CLASS_::get_max_num_breaks_possible() const {
 }
 
 CNF_FORMULA_TEMPLATE_
-clause_t CNF_FORMULA_CLASS_::get_clause(num_t clause_index) const {
-	return clauses[clause_index];
+std::size_t CNF_FORMULA_CLASS_::get_max_clause_width() const {
+	return max_clause_width;
 }
 
+CNF_FORMULA_TEMPLATE_
+std::size_t CNF_FORMULA_CLASS_::get_uniform_clause_width() const {
+	return uniform_clause_width;
+}
+
+CNF_FORMULA_TEMPLATE_
+std::size_t CNF_FORMULA_CLASS_::get_num_literals() const {
+	return num_literals;
+}
+
+CNF_FORMULA_TEMPLATE_
+std::size_t CNF_FORMULA_CLASS_::get_memory_usage() const {
+	// every literal is stored in its clause and once more in the occurrence list of its variable
+	return 2 * num_literals * sizeof(num_t) + ((std::size_t) num_clauses()) * sizeof(sum_t)
+		+ (((std::size_t) num_vars()) + 1) * sizeof(std::pair<sum_t, cnt_t>);
+}
+
+#if USE_FLAT_CLAUSE_STORAGE
+
+	CNF_FORMULA_TEMPLATE_
+	clause_t CNF_FORMULA_CLASS_::get_clause(num_t clause_index) const {
+		const clause_view_t clause = clauses[clause_index];
+		return clause_t(clause.begin(), clause.end(), clause.num_vars());
+	}
+
+	CNF_FORMULA_TEMPLATE_
+	typename CNF_FORMULA_CLASS_::clause_view_t CNF_FORMULA_CLASS_::get_clause_view(num_t clause_index) const {
+		return clauses[clause_index];
+	}
+
+#else
+
+	CNF_FORMULA_TEMPLATE_
+	clause_t CNF_FORMULA_CLASS_::get_clause(num_t clause_index) const {
+		return clauses[clause_index];
+	}
+
+	CNF_FORMULA_TEMPLATE_
+	typename CNF_FORMULA_CLASS_::clause_view_t CNF_FORMULA_CLASS_::get_clause_view(num_t clause_index) const {
+		return clauses[clause_index].view();
+	}
+
+#endif
+
 
 #if USE_CONT_DATASTRUCT
 
@@ -165,6 +278,16 @@ clause_t CNF_FORMULA_CLASS_::get_clause(num_t clause_index) const {
 		return std::make_tuple(neg_start, neg_end, pos_start, pos_end);
 	}
 
+	CNF_FORMULA_TEMPLATE_
+	std::pair<sum_t, cnt_t> CNF_FORMULA_CLASS_::get_occurrence_offset(num_t var_index) const {
+		return occurrence_offset[var_index];
+	}
+
+	CNF_FORMULA_TEMPLATE_
+	const num_t* CNF_FORMULA_CLASS_::get_clauses_with_vars() const {
+		return clauses_with_vars.data();
+	}
+
 #else
 
 	CNF_FORMULA_TEMPLATE_
@@ -205,6 +328,196 @@ CNF_FORMULA_CLASS_::cnf_formula(std::string filename, const bool load) {
 	}
 }
 
+#if USE_FLAT_CLAUSE_STORAGE && USE_CONT_DATASTRUCT
+
+	CNF_FORMULA_TEMPLATE_
+	void CNF_FORMULA_CLASS_::save_binary(const std::string &filename) const {
+		static constexpr std::size_t width = clause_view_t::static_width;
+
+		binary_formula_header header = {};
+		std::memcpy(header.magic, binary_formula_magic, sizeof(binary_formula_magic));
+		header.version = binary_formula_version;
+		header.byte_order = binary_formula_byte_order;
+		header.num_size = sizeof(num_t);
+		header.sum_size = sizeof(sum_t);
+		header.cnt_size = sizeof(cnt_t);
+		header.occurrence_record_size = sizeof(std::pair<sum_t, cnt_t>);
+		header.static_width = width;
+		header.num_vars = num_vars();
+		header.num_clauses = num_clauses();
+		header.num_literals = num_literals;
+		header.num_occurrences = clauses_with_vars.size();
+		header.max_num_breaks_possible = max_num_breaks_possible;
+		header.max_clause_width = max_clause_width;
+		header.uniform_clause_width = uniform_clause_width;
+
+		std::ofstream filehandle(filename, std::ios::binary | std::ios::trunc);
+		if (!filehandle) {
+			throw std::runtime_error("can't open '" + filename + "' for writing");
+		}
+
+		// the header is written again with the positions of the arrays
+		uint64_t pos = 0;
+		write_binary_formula_array(filehandle, pos, &header, 1);
+
+		const auto &literals = clauses.get_literals();
+		header.literals_pos = write_binary_formula_array(filehandle, pos, literals.data(), literals.size());
+		if constexpr (0 == width) {
+			const auto &offsets = clauses.get_offsets();
+			header.offsets_pos = write_binary_formula_array(filehandle, pos, offsets.data(), offsets.size());
+		}
+		header.occurrence_offset_pos = write_binary_formula_pairs(filehandle, pos, occurrence_offset.data(), occurrence_offset.size());
+		header.clauses_with_vars_pos = write_binary_formula_array(filehandle, pos, clauses_with_vars.data(), clauses_with_vars.size());
+		header.file_size = pos;
+
+		filehandle.seekp(0);
+		filehandle.write((const char*) &header, sizeof(header));
+
+		// write errors of the buffered data (e.g. a full disk) are only reported by the flush in close
+		filehandle.close();
+		if (!filehandle) {
+			throw std::runtime_error("writing '" + filename + "' failed");
+		}
+	}
+
+
+	CNF_FORMULA_TEMPLATE_
+	CNF_FORMULA_CLASS_::cnf_formula(const std::shared_ptr<const mapped_file> &image) {
+		static constexpr std::size_t width = clause_view_t::static_width;
+		const binary_formula_header &header = get_binary_formula_header(*image);
+		file = image->name();
+
+		if ((sizeof(num_t) != header.num_size) || (sizeof(sum_t) != header.sum_size) || (sizeof(cnt_t) != header.cnt_size)
+			|| (sizeof(std::pair<sum_t, cnt_t>) != header.occurrence_record_size) || (width != header.static_width))
+		{
+			throw std::runtime_error("binary formula '" + file + "' doesn't match the requested types");
+		}
+
+		if ((header.num_vars >= (uint64_t) std::numeric_limits<num_t>::max())
+			|| (header.num_clauses >= (uint64_t) std::numeric_limits<num_t>::max())
+			|| (header.num_literals > (uint64_t) std::numeric_limits<sum_t>::max()))
+		{
+			throw std::out_of_range("binary formula '" + file + "': types are too small");
+		}
+
+		num_variables = header.num_vars;
+		max_num_breaks_possible = header.max_num_breaks_possible;
+		max_clause_width = header.max_clause_width;
+		uniform_clause_width = header.uniform_clause_width;
+		num_literals = header.num_literals;
+
+		const num_t *lits = get_binary_formula_array<num_t>(*image, header.literals_pos, header.num_literals);
+		const sum_t *offs = nullptr;
+		if constexpr (0 == width) {
+			offs = get_binary_formula_array<sum_t>(*image, header.offsets_pos, header.num_clauses + 1);
+		}
+		clauses.map(image, lits, header.num_literals, offs, header.num_clauses);
+
+		occurrence_offset.map(image, get_binary_formula_array<std::pair<sum_t, cnt_t>>(*image,
+			header.occurrence_offset_pos, header.num_vars + 1), header.num_vars + 1);
+		clauses_with_vars.map(image, get_binary_formula_array<num_t>(*image,
+			header.clauses_with_vars_pos, header.num_occurrences), header.num_occurrences);
+
+		// only the ends of the arrays are checked, checking every entry would touch all pages
+		#if VERIFY_INPUT
+			if (((0 == width) && ((sum_t) header.num_literals != offs[header.num_clauses]))
+				|| ((0 < width) && (header.num_literals != header.num_clauses * width))
+				|| ((sum_t) header.num_occurrences != occurrence_offset[num_variables].first)
+				|| (header.num_occurrences != header.num_literals))
+			{
+				throw std::runtime_error("invalid binary formula '" + file + "': array lengths don't match");
+			}
+		#endif
+	}
+
+#endif
+
+
+CNF_FORMULA_TEMPLATE_
+template<typename other_num_t, typename other_sum_t, typename other_cnt_t, class other_clause_t>
+CNF_FORMULA_CLASS_::cnf_formula(cnf_formula<other_num_t, other_sum_t, other_cnt_t, other_clause_t> &&other)
+	: num_variables(other.num_variables),
+	max_num_breaks_possible(other.max_num_breaks_possible),
+	file(other.file)
+{
+	#if VERIFY_INPUT
+		if ((other.num_vars() > std::numeric_limits<num_t>::max())
+			|| (other.num_clauses() > std::numeric_limits<num_t>::max())
+			|| (other.max_num_breaks_possible > std::numeric_limits<cnt_t>::max())
+			|| (other.get_num_literals() > (std::size_t) std::numeric_limits<sum_t>::max()))
+		{
+			throw std::out_of_range("cnf_formula: types are too small for converted formula!");
+		}
+	#endif
+
+	// the occurrence lists don't depend on the clause type, they are taken over if the types match
+	if constexpr (std::is_same<decltype(clauses_with_vars), decltype(other.clauses_with_vars)>::value) {
+		clauses_with_vars = std::move(other.clauses_with_vars);
+	} else {
+		#if USE_CONT_DATASTRUCT
+			clauses_with_vars.assign(other.clauses_with_vars.begin(), other.clauses_with_vars.end());
+		#else
+			clauses_with_vars.resize(other.clauses_with_vars.size());
+			for (std::size_t i = 0; i < clauses_with_vars.size(); i++) {
+				auto &o = other.clauses_with_vars[i];
+				clauses_with_vars[i].first.assign(o.first.begin(), o.first.end());
+				clauses_with_vars[i].second.assign(o.second.begin(), o.second.end());
+			}
+		#endif
+		other.clauses_with_vars = decltype(other.clauses_with_vars)(); // free the memory
+	}
+
+	#if USE_CONT_DATASTRUCT
+		if constexpr (std::is_same<decltype(occurrence_offset), decltype(other.occurrence_offset)>::value) {
+			occurrence_offset = std::move(other.occurrence_offset);
+		} else {
+			occurrence_offset.assign(other.occurrence_offset.begin(), other.occurrence_offset.end());
+			other.occurrence_offset = decltype(other.occurrence_offset)();
+		}
+	#endif
+
+	clauses.reserve(other.num_clauses());
+	for (other_num_t clause_index = 0; clause_index < other.num_clauses(); clause_index++) {
+		const auto clause = other.get_clause_view(clause_index);
+		#if USE_FLAT_CLAUSE_STORAGE
+			clauses.push_back(clause);
+		#else
+			clauses.push_back(clause_t(clause.begin(), clause.end(), clause.num_vars()));
+		#endif
+	}
+
+	other.clauses = decltype(other.clauses)(); // free the memory
+	determine_clause_widths();
+}
+
+
+CNF_FORMULA_TEMPLATE_
+std::shared_ptr<CNF_FORMULA_CLASS_> CNF_FORMULA_CLASS_::make_local_copy() const {
+	// member wise, the formula isn't copyable with ENALBE_CNF_MULTITHREAD_SHARING (mutex)
+	auto copy = std::make_shared<CNF_FORMULA_CLASS_>(file, false);
+	copy->num_variables = num_variables;
+	copy->max_num_breaks_possible = max_num_breaks_possible;
+	copy->max_clause_width = max_clause_width;
+	copy->uniform_clause_width = uniform_clause_width;
+	copy->num_literals = num_literals;
+
+	// the assignments copy owned arrays in this thread, mapped arrays are shared until unmap() copies them
+	copy->clauses = clauses;
+	#if USE_FLAT_CLAUSE_STORAGE
+		copy->clauses.unmap();
+	#endif
+	#if USE_CONT_DATASTRUCT
+		copy->occurrence_offset = occurrence_offset;
+		copy->occurrence_offset.unmap();
+		copy->clauses_with_vars = clauses_with_vars;
+		copy->clauses_with_vars.unmap();
+	#else
+		copy->clauses_with_vars = clauses_with_vars;
+	#endif
+
+	return copy;
+}
+
 
 CNF_FORMULA_TEMPLATE_
 void CNF_FORMULA_CLASS_::initialize() {
@@ -228,10 +541,26 @@ void CNF_FORMULA_CLASS_::initialize() {
 
 	clauses.clear();
 
-	std::ifstream filehandle;
-	filehandle.open(file);
-	num_variables = read<num_t, cnt_t, clause_t>(filehandle, clauses, count_clauses_with_vars);
-	filehandle.close();
+	#if USE_FLAT_CLAUSE_STORAGE && USE_CONT_DATASTRUCT && USE_PARALLEL_PARSING
+		// large files are split into chunks of lines, the resulting formula is the same
+		const unsigned num_threads = num_parser_threads();
+		std::error_code error;
+		const std::uintmax_t file_size = std::filesystem::file_size(file, error);
+
+		// compressed files can't be split
+		if (!error && (1 < num_threads) && (PARALLEL_PARSING_MIN_BYTES <= file_size) && (compression::none == detect_compression(file))) {
+			num_variables = read_parallel<num_t, cnt_t, clause_t>(file, clauses, count_clauses_with_vars, num_threads);
+			determine_clause_widths();
+			build_occurrence_index_parallel(count_clauses_with_vars, num_threads);
+			return;
+		}
+	#endif
+
+	std::unique_ptr<std::istream> filehandle = open_dimacs(file);
+	num_variables = read<num_t, cnt_t, clause_t>(*filehandle, clauses, count_clauses_with_vars);
+	filehandle.reset();
+
+	determine_clause_widths();
 
 	#if USE_CONT_DATASTRUCT
 		cnf_formula_constructor_variant_cont_datastruct(count_clauses_with_vars);
@@ -239,7 +568,7 @@ void CNF_FORMULA_CLASS_::initialize() {
 		clauses_with_vars.resize(num_vars());
 
 		for (num_t clause_index = 0; clause_index < num_clauses(); clause_index++) {
-			const clause_t clause = get_clause(clause_index);
+			const clause_view_t clause = get_clause_view(clause_index);
 			for (std::size_t i = 0; i < clause.num_vars(); i++) {
 				num_t lit = clause[i];
 				num_t var_index = abs(lit)-1;
@@ -268,7 +597,7 @@ void CNF_FORMULA_CLASS_::initialize() {
 			add_check_clauses_with_vars.resize(num_vars());
 
 			for (num_t clause_index = 0; clause_index < num_clauses(); clause_index++) {
-				const clause_t clause = get_clause(clause_index);
+				const clause_view_t clause = get_clause_view(clause_index);
 				for (std::size_t i = 0; i < clause.num_vars(); i++) {
 					num_t lit = clause[i];
 					num_t var_index = abs(lit)-1;
@@ -311,7 +640,7 @@ void CNF_FORMULA_CLASS_::initialize() {
 		clauses_with_vars.resize(sum);
 
 		for (num_t clause_index = 0; clause_index < num_clauses(); clause_index++) {
-			const clause_t clause = get_clause(clause_index);
+			const clause_view_t clause = get_clause_view(clause_index);
 			for (std::size_t i = 0; i < clause.num_vars(); i++) {
 				num_t lit = clause[i];
 				num_t var_index = abs(lit)-1;
@@ -379,13 +708,119 @@ void CNF_FORMULA_CLASS_::initialize() {
 	}
 #endif
 
+#if USE_CONT_DATASTRUCT && USE_PARALLEL_PARSING
+	CNF_FORMULA_TEMPLATE_
+	void CNF_FORMULA_CLASS_::build_occurrence_index_parallel(const std::vector<std::pair<cnt_t, cnt_t>> &count_clauses_with_vars, const unsigned num_threads) {
+		const std::size_t n = num_vars();
+
+		// occurrence_offset[i] ist Summe von j=0 bis i-1 über count_clauses_with_vars[j], first per block of variables
+		std::vector<std::size_t> block_offset(num_threads + 1, 0);
+		parallel_for(n, num_threads, [&](const std::size_t first, const std::size_t last, const unsigned part) {
+			std::size_t sum = 0;
+			for (std::size_t i = first; i < last; i++) {
+				sum += (std::size_t) count_clauses_with_vars[i].first + count_clauses_with_vars[i].second;
+			}
+			block_offset[part+1] = sum;
+		});
+		for (unsigned part = 0; part < num_threads; part++) {
+			block_offset[part+1] += block_offset[part];
+		}
+
+		const std::size_t sum = block_offset[num_threads];
+		#if VERIFY_INPUT
+			if (sum > (std::size_t) std::numeric_limits<sum_t>::max()) {
+				throw std::out_of_range("cnf_formula: sum_t is too small!");
+			}
+		#endif
+
+		occurrence_offset.resize(n + 1);
+		occurrence_offset[n].first = sum;
+		occurrence_offset[n].second = 0;
+		clauses_with_vars.resize(sum);
+
+		// the clauses are split into parts, next_free[part][2*i] / [2*i+1] is the position of the first negative / positive
+		// occurrence of variable i+1 in that part (histogram of the part, then exclusive prefix sum over the parts),
+		// so every thread places the occurrences of its own clauses in the order of the serial construction without atomics.
+		// Not more parts than literals per variable, the histograms need at most about twice the memory of the occurrences
+		const unsigned num_parts = (unsigned) std::max<std::size_t>(1, std::min<std::size_t>(num_threads, num_literals / std::max<std::size_t>(1, n)));
+		std::vector<std::vector<sum_t>> next_free(num_parts);
+
+		parallel_for(num_clauses(), num_parts, [&](const std::size_t first, const std::size_t last, const unsigned part) {
+			std::vector<sum_t> &count = next_free[part];
+			count.assign(2 * n, 0);
+			for (std::size_t clause_index = first; clause_index < last; clause_index++) {
+				const clause_view_t clause = get_clause_view((num_t) clause_index);
+				for (std::size_t i = 0; i < clause.num_vars(); i++) {
+					const num_t lit = clause[i];
+					count[2 * (abs(lit)-1) + (0 < lit)]++;
+				}
+			}
+		});
+
+		parallel_for(n, num_threads, [&](const std::size_t first, const std::size_t last, const unsigned part) {
+			sum_t offset = block_offset[part];
+			for (std::size_t i = first; i < last; i++) {
+				occurrence_offset[i].first = offset;
+				occurrence_offset[i].second = count_clauses_with_vars[i].first;
+
+				// variable-major, part-minor: the negative occurrences of all parts, then the positive ones
+				sum_t negative = offset, positive = offset + count_clauses_with_vars[i].first;
+				for (std::vector<sum_t> &count : next_free) {
+					const sum_t num_negative = count[2 * i], num_positive = count[2 * i + 1];
+					count[2 * i] = negative;
+					count[2 * i + 1] = positive;
+					negative += num_negative;
+					positive += num_positive;
+				}
+				assert((0 == ADDITIONAL_CHECKS) || (positive == offset + count_clauses_with_vars[i].first + count_clauses_with_vars[i].second));
+				offset = positive;
+			}
+		});
+
+		num_t *occurrences = clauses_with_vars.data();
+		parallel_for(num_clauses(), num_parts, [&](const std::size_t first, const std::size_t last, const unsigned part) {
+			std::vector<sum_t> &position = next_free[part];
+			for (std::size_t clause_index = first; clause_index < last; clause_index++) {
+				const clause_view_t clause = get_clause_view((num_t) clause_index);
+				for (std::size_t i = 0; i < clause.num_vars(); i++) {
+					const num_t lit = clause[i];
+					occurrences[position[2 * (abs(lit)-1) + (0 < lit)]++] = (num_t) clause_index;
+				}
+			}
+		});
+
+		for (std::size_t i = 0; i < n; i++) {
+			const std::pair<cnt_t, cnt_t> &cnt = count_clauses_with_vars[i];
+			max_num_breaks_possible = std::max(max_num_breaks_possible, (num_t) std::max(cnt.first, cnt.second));
+		}
+	}
+#endif
+
+
 // debug function:
+CNF_FORMULA_TEMPLATE_
+void CNF_FORMULA_CLASS_::determine_clause_widths() {
+	max_clause_width = 0;
+	uniform_clause_width = (0 < num_clauses()) ? get_clause_view(0).num_vars() : 0;
+	num_literals = 0;
+
+	for (num_t clause_index = 0; clause_index < num_clauses(); clause_index++) {
+		const std::size_t width = get_clause_view(clause_index).num_vars();
+		max_clause_width = std::max(max_clause_width, width);
+		num_literals += width;
+		if (width != uniform_clause_width) {
+			uniform_clause_width = 0;
+		}
+	}
+}
+
+
 CNF_FORMULA_TEMPLATE_
 void CNF_FORMULA_CLASS_::debug_output_formula() const {
 	std::cout << "got " << clauses.size() << " clauses with " << num_vars() << " variables:\n" << std::endl;
 
-	for (const auto c : clauses) {
-		std::cout << c << std::endl;
+	for (num_t clause_index = 0; clause_index < num_clauses(); clause_index++) {
+		std::cout << get_clause_view(clause_index) << std::endl;
 	}
 }
 
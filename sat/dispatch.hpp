@@ -0,0 +1,226 @@
+#ifndef DISPATCH_HPP
+#define DISPATCH_HPP
+
+// Auswahl der passenden (spezialisierten) Datentypen und Klauseldarstellung zur Laufzeit
+
+#include "cnf_formula.hpp"
+#include "clause.hpp"
+#include "3sat-clause.hpp"
+#include "binary_formula.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+
+// loads a formula and calls f(std::shared_ptr<const formula_t>) with the narrowest instantiation:
+// num_t is int16_t, int32_t or int64_t depending on the number of variables and clauses,
+// sum_t and cnt_t depend on the number of literals and occurrences:
+//   <int16_t, int32_t, int16_t>, <int32_t, int32_t, int16_t>, <int32_t, int32_t, int32_t>, <int32_t, int64_t, int32_t>,
+//   <int64_t, int64_t, int32_t>
+// uniform 3-, 5- and 7-SAT formulas use static_clause_k (if specialize_clauses), all others generic_clause
+// binary formulas (see cnf2bin) are mapped with the types they were written with instead of being parsed
+template<typename F>
+void load_cnf_formula(const std::string &filename, F &&f, const bool specialize_clauses = true);
+
+// e.g. "int32_t/int32_t/int16_t, 3-sat clauses" for output
+template<class formula_t>
+std::string describe_types(const formula_t &bformula);
+
+
+// *********************************************************************
+// Implementation:
+// *********************************************************************
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+
+// the formula is parsed with wide sum_t and cnt_t, they are narrowed afterwards
+template<typename num_t>
+using parsed_cnf_formula = cnf_formula<num_t, int64_t, int32_t, generic_clause<num_t>>;
+
+
+template<typename num_t, typename sum_t, typename cnt_t, class clause_t, typename other_num_t, typename F>
+void call_with_converted_formula(parsed_cnf_formula<other_num_t> &&parsed, F &&f) {
+	using formula_t = cnf_formula<num_t, sum_t, cnt_t, clause_t>;
+	std::shared_ptr<const formula_t> bformula = std::make_shared<const formula_t>(std::move(parsed));
+	f(bformula);
+}
+
+
+template<typename num_t, typename sum_t, typename cnt_t, typename other_num_t, typename F>
+void dispatch_clause_width(parsed_cnf_formula<other_num_t> &&parsed, F &&f, const bool specialize_clauses) {
+	switch (specialize_clauses ? parsed.get_uniform_clause_width() : 0) {
+		case 3:
+			call_with_converted_formula<num_t, sum_t, cnt_t, static_clause_k<num_t, 3>>(std::move(parsed), f);
+			break;
+		case 5:
+			call_with_converted_formula<num_t, sum_t, cnt_t, static_clause_k<num_t, 5>>(std::move(parsed), f);
+			break;
+		case 7:
+			call_with_converted_formula<num_t, sum_t, cnt_t, static_clause_k<num_t, 7>>(std::move(parsed), f);
+			break;
+		default:
+			call_with_converted_formula<num_t, sum_t, cnt_t, generic_clause<num_t>>(std::move(parsed), f);
+	}
+}
+
+
+template<typename num_t, typename F>
+void load_cnf_formula_with(const std::string &filename, F &&f, const bool specialize_clauses) {
+	parsed_cnf_formula<num_t> parsed(filename);
+
+	[[maybe_unused]] const bool small_sum = (parsed.get_num_literals() < (std::size_t) std::numeric_limits<int32_t>::max());
+	[[maybe_unused]] const bool small_cnt = (parsed.get_max_num_breaks_possible() < std::numeric_limits<int16_t>::max());
+
+	if constexpr (std::is_same<num_t, int16_t>::value) {
+		// less than 2^15 clauses, so less than 2^15 occurrences per literal and less than 2^30 literals
+		dispatch_clause_width<int16_t, int32_t, int16_t>(std::move(parsed), f, specialize_clauses);
+	} else if constexpr (std::is_same<num_t, int32_t>::value) {
+		if (small_sum && small_cnt) {
+			dispatch_clause_width<int32_t, int32_t, int16_t>(std::move(parsed), f, specialize_clauses);
+		} else if (small_sum) {
+			dispatch_clause_width<int32_t, int32_t, int32_t>(std::move(parsed), f, specialize_clauses);
+		} else {
+			// 2^31 or more literals, only the offsets need 64 bits, the literals and clause indices stay narrow
+			dispatch_clause_width<int32_t, int64_t, int32_t>(std::move(parsed), f, specialize_clauses);
+		}
+	} else {
+		dispatch_clause_width<int64_t, int64_t, int32_t>(std::move(parsed), f, specialize_clauses);
+	}
+}
+
+
+#if USE_FLAT_CLAUSE_STORAGE && USE_CONT_DATASTRUCT
+
+	template<typename num_t, typename sum_t, typename cnt_t, class clause_t, typename F>
+	void call_with_mapped_formula(const std::shared_ptr<const mapped_file> &image, F &&f, const bool specialize_clauses) {
+		using formula_t = cnf_formula<num_t, sum_t, cnt_t, clause_t>;
+
+		if (specialize_clauses || (0 == clause_t::view_type::static_width)) {
+			std::shared_ptr<const formula_t> bformula = std::make_shared<const formula_t>(image);
+			f(bformula);
+		} else {
+			// the file has no clause offsets, they are created by converting to generic clauses
+			using generic_formula_t = cnf_formula<num_t, sum_t, cnt_t, generic_clause<num_t>>;
+			std::shared_ptr<const generic_formula_t> bformula = std::make_shared<const generic_formula_t>(formula_t(image));
+			f(bformula);
+		}
+	}
+
+
+	template<typename num_t, typename sum_t, typename cnt_t, typename F>
+	void dispatch_mapped_clause_width(const std::shared_ptr<const mapped_file> &image, const uint64_t static_width,
+		F &&f, const bool specialize_clauses)
+	{
+		switch (static_width) {
+			case 3:
+				call_with_mapped_formula<num_t, sum_t, cnt_t, static_clause_k<num_t, 3>>(image, f, specialize_clauses);
+				break;
+			case 5:
+				call_with_mapped_formula<num_t, sum_t, cnt_t, static_clause_k<num_t, 5>>(image, f, specialize_clauses);
+				break;
+			case 7:
+				call_with_mapped_formula<num_t, sum_t, cnt_t, static_clause_k<num_t, 7>>(image, f, specialize_clauses);
+				break;
+			case 0:
+				call_with_mapped_formula<num_t, sum_t, cnt_t, generic_clause<num_t>>(image, f, specialize_clauses);
+				break;
+			default:
+				throw std::runtime_error("binary formula '" + image->name() + "' has unsupported clause width "
+					+ std::to_string(static_width));
+		}
+	}
+
+#endif
+
+
+#if USE_FLAT_CLAUSE_STORAGE && USE_CONT_DATASTRUCT
+
+	// the integer types of the file are one of the combinations load_cnf_formula_with chooses
+	template<typename F>
+	void load_binary_cnf_formula(const std::shared_ptr<const mapped_file> &image, F &&f, const bool specialize_clauses) {
+		const binary_formula_header &header = get_binary_formula_header(*image);
+
+		const auto types = std::make_tuple(header.num_size, header.sum_size, header.cnt_size);
+		if (std::make_tuple(2u, 4u, 2u) == types) {
+			dispatch_mapped_clause_width<int16_t, int32_t, int16_t>(image, header.static_width, f, specialize_clauses);
+		} else if (std::make_tuple(4u, 4u, 2u) == types) {
+			dispatch_mapped_clause_width<int32_t, int32_t, int16_t>(image, header.static_width, f, specialize_clauses);
+		} else if (std::make_tuple(4u, 4u, 4u) == types) {
+			dispatch_mapped_clause_width<int32_t, int32_t, int32_t>(image, header.static_width, f, specialize_clauses);
+		} else if (std::make_tuple(4u, 8u, 4u) == types) {
+			dispatch_mapped_clause_width<int32_t, int64_t, int32_t>(image, header.static_width, f, specialize_clauses);
+		} else if (std::make_tuple(8u, 8u, 4u) == types) {
+			dispatch_mapped_clause_width<int64_t, int64_t, int32_t>(image, header.static_width, f, specialize_clauses);
+		} else {
+			throw std::runtime_error("binary formula '" + image->name() + "' has unsupported integer types");
+		}
+	}
+
+#endif
+
+
+template<typename F>
+void load_binary_cnf_formula(const std::string &filename, F &&f, const bool specialize_clauses) {
+	#if USE_FLAT_CLAUSE_STORAGE && USE_CONT_DATASTRUCT
+		load_binary_cnf_formula(std::make_shared<const mapped_file>(filename), f, specialize_clauses);
+	#else
+		ignore(f, specialize_clauses);
+		throw std::runtime_error("binary formula '" + filename + "' requires USE_FLAT_CLAUSE_STORAGE and USE_CONT_DATASTRUCT");
+	#endif
+}
+
+
+template<typename int_t>
+std::string int_type_name() {
+	return (std::numeric_limits<int_t>::is_signed ? "int" : "uint") + std::to_string(8 * sizeof(int_t)) + "_t";
+}
+
+
+template<class formula_t>
+std::string describe_types(const formula_t &bformula) {
+	static constexpr std::size_t width = formula_t::clause_view_t::static_width;
+	ignore(bformula);
+
+	return int_type_name<typename formula_t::num_type>() + "/" + int_type_name<typename formula_t::sum_type>()
+		+ "/" + int_type_name<typename formula_t::cnt_type>() + ", "
+		+ ((0 < width) ? (std::to_string(width) + "-sat clauses") : "generic clauses");
+}
+
+
+template<typename F>
+void load_cnf_formula(const std::string &filename, F &&f, const bool specialize_clauses) {
+	if (is_binary_formula(filename)) {
+		load_binary_cnf_formula(filename, f, specialize_clauses);
+		return;
+	}
+
+	int64_t num_vars = 0;
+	int64_t num_clauses = 0;
+
+	{
+		std::unique_ptr<std::istream> filehandle = open_dimacs(filename);
+		if (!*filehandle) {
+			throw std::runtime_error("can't open '" + filename + "'");
+		}
+		read_header(*filehandle, num_vars, num_clauses);
+	}
+
+	// clause indices and literals are stored as num_t
+	const int64_t max_index = std::max(num_vars, num_clauses);
+	if (max_index < std::numeric_limits<int16_t>::max()) {
+		load_cnf_formula_with<int16_t>(filename, f, specialize_clauses);
+	} else if (max_index < std::numeric_limits<int32_t>::max()) {
+		load_cnf_formula_with<int32_t>(filename, f, specialize_clauses);
+	} else {
+		load_cnf_formula_with<int64_t>(filename, f, specialize_clauses);
+	}
+}
+
+#endif
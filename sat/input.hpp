@@ -6,6 +6,8 @@
 #include "../config.hpp"
 
 #include <iostream>
+#include <memory>
+#include <string>
 #include <vector>
 #include <cassert>
 
@@ -19,32 +21,222 @@
 #define ALLOW_UNCLEAN_CLAUSES 1
 #endif
 
-template<typename num_t, typename cnt_t, typename clause_t>
-num_t read(std::istream& is, std::vector<clause_t> &clauses,
+// clause_storage_t is a std::vector<clause_t> or a flat_clause_storage
+// clauses are sequences of literals terminated by 0, they may span several lines and share lines
+template<typename num_t, typename cnt_t, typename clause_t, typename clause_storage_t>
+num_t read(std::istream& is, clause_storage_t &clauses,
 	std::vector<std::pair<cnt_t, cnt_t>> &count_clauses_with_vars);
 
+// reads only up to the p line, e.g. to choose the integer types before the formula is parsed
+void read_header(std::istream& is, int64_t &num_vars, int64_t &num_clauses);
+
+// opens a DIMACS file for read() or read_header(), compressed files (gzip, xz, zstd) are
+// recognized by their magic bytes and decompressed by another thread while they are parsed
+std::unique_ptr<std::istream> open_dimacs(const std::string &filename);
+
+// number of threads used for large formulas (see USE_PARALLEL_PARSING), all hardware threads by default
+unsigned& num_parser_threads();
+
+// same result as read() for a flat_clause_storage, but the file is split into chunks of lines which are
+// parsed by num_threads threads and merged afterwards, so clauses may span chunks as well
+template<typename num_t, typename cnt_t, typename clause_t, typename clause_storage_t>
+num_t read_parallel(const std::string &filename, clause_storage_t &clauses,
+	std::vector<std::pair<cnt_t, cnt_t>> &count_clauses_with_vars, const unsigned num_threads);
+
 
 // *********************************************************************
 // Implementation:
 // *********************************************************************
 
-#include <string>
-#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
 
 #include "../util/util.hpp"
+#include "../util/parallel.hpp"
+#include "../util/decompressing_stream.hpp"
+
+
+// reads the stream in large blocks and splits it into tokens, counts lines for error messages
+class dimacs_scanner {
+	private:
+		static constexpr std::size_t lookahead = 64; // a token is always completely in the buffer (longer ones are invalid)
+
+		std::istream &is;
+		std::vector<char> buffer;
+		char *pos; // next character
+		char *end; // end of the valid data, *end is always 0
+		std::size_t line = 1;
+		std::size_t bytes_read = 0;
+		const std::size_t limit; // max. number of bytes read from the stream
+
+		// moves the rest of the buffer to the front and reads more data, false if nothing was read
+		bool refill() {
+			const std::size_t rest = end - pos;
+			std::memmove(buffer.data(), pos, rest);
+			pos = buffer.data();
+
+			is.read(buffer.data() + rest, std::min(buffer.size() - 1 - rest, limit - bytes_read));
+			const std::size_t num_read = is.gcount();
+			bytes_read += num_read;
+			end = pos + rest + num_read;
+			*end = 0;
+			return 0 < num_read;
+		}
+
+		inline void ensure_lookahead() {
+			if (((std::size_t) (end - pos) < lookahead) && is && (bytes_read < limit)) {
+				refill();
+			}
+		}
+
+		[[noreturn]] void invalid_character() const {
+			throw std::runtime_error(std::string("invalid format: unexpected character '") + *pos + "'");
+		}
+
+	public:
+		// reads at most max_bytes from the current position of the stream, e.g. a chunk of lines
+		dimacs_scanner(std::istream &input, const std::size_t buffer_size = 1 << 20,
+			const std::size_t max_bytes = std::numeric_limits<std::size_t>::max()) :
+			is(input), buffer(std::max(buffer_size, 2 * lookahead) + 1), limit(max_bytes)
+		{
+			pos = end = buffer.data();
+			*end = 0;
+		}
+
+		std::size_t get_line() const {
+			return line;
+		}
+
+		// number of characters consumed (relative to the start position of the stream)
+		std::size_t get_offset() const {
+			return bytes_read - (end - pos);
+		}
+
+		// skips spaces, tabs and line breaks, returns the next character or 0 at the end of the input
+		inline char skip_whitespace() {
+			while (true) {
+				while (pos < end) {
+					const char c = *pos;
+					if ('\n' == c) {
+						line++;
+					} else if ((' ' != c) && ('\t' != c) && ('\r' != c)) {
+						ensure_lookahead();
+						return *pos;
+					}
+					pos++;
+				}
+
+				if (!refill()) {
+					return 0;
+				}
+			}
+		}
+
+		// skips spaces and tabs but no line breaks, returns the next character ('\n' or 0 at the end of the line)
+		inline char skip_blanks() {
+			while (true) {
+				while ((pos < end) && ((' ' == *pos) || ('\t' == *pos) || ('\r' == *pos))) {
+					pos++;
+				}
+
+				if ((pos < end) || !refill()) {
+					ensure_lookahead();
+					return (pos < end) ? *pos : 0;
+				}
+			}
+		}
+
+		// skips the rest of the line including the line break (comments)
+		void skip_line() {
+			while (true) {
+				char *nl = (char*) std::memchr(pos, '\n', end - pos);
+				if (nullptr != nl) {
+					pos = nl + 1;
+					line++;
+					return;
+				}
+
+				pos = end;
+				if (!refill()) {
+					return;
+				}
+			}
+		}
+
+		// the next token must be word, it's skipped
+		void expect_word(const char *word, const char *error) {
+			const std::size_t n = std::strlen(word);
+			ensure_lookahead();
+			if (((std::size_t) (end - pos) < n) || (0 != std::memcmp(pos, word, n))) {
+				throw std::runtime_error(error);
+			}
+			pos += n;
+		}
+
+		// reads a decimal integer with optional sign at the current position (whitespace is skipped before),
+		// the token has to end with whitespace or the end of the input
+		inline int64_t read_integer() {
+			const bool negative = ('-' == *pos);
+			if (negative) {
+				pos++;
+			}
+
+			// the lookahead guarantees that a valid number is in the buffer, *end = 0 stops the loop
+			uint64_t value = 0;
+			const char *first = pos;
+			while ((unsigned) (*pos - '0') < 10) {
+				value = 10 * value + (*pos - '0');
+				pos++;
+			}
+
+			if (first == pos) {
+				invalid_character();
+			}
+			if (18 < (pos - first)) {
+				throw std::out_of_range("integer is too large");
+			}
+			if ((pos < end) && (' ' != *pos) && ('\n' != *pos) && ('\t' != *pos) && ('\r' != *pos)) {
+				invalid_character();
+			}
+
+			return negative ? -((int64_t) value) : (int64_t) value;
+		}
+
+		// current character is skipped
+		inline void advance() {
+			pos++;
+		}
+
+		// wheter the current character is a space or tab
+		bool at_blank() {
+			ensure_lookahead();
+			return (pos < end) && ((' ' == *pos) || ('\t' == *pos));
+		}
+};
 
 
 template<typename num_t>
-inline void parse_configuration(std::istringstream &line_iss, std::string &line, std::string &field, num_t &num_vars, num_t &num_clauses);
+inline void parse_configuration(dimacs_scanner &scanner, num_t &num_vars, num_t &num_clauses);
 
-template<typename num_t, typename cnt_t, typename clause_t>
-inline void parse_clause(std::istringstream &line_iss, std::string &line, std::string &field,
-	std::vector<clause_t> &clauses, std::vector<std::pair<cnt_t, cnt_t>> &count_clauses_with_vars);
+// throws for empty and (with ALLOW_UNCLEAN_CLAUSES 0) unclean clauses,
+// returns false if the clause is always true and has to be dropped
+template<typename num_t>
+inline bool verify_clause(const num_t *literals, const std::size_t n);
+
+// returns false if the clause was dropped because it's always true
+template<typename num_t, typename cnt_t, typename clause_t, typename clause_storage_t>
+inline bool add_clause(const std::vector<num_t> &literals, clause_storage_t &clauses,
+	std::vector<std::pair<cnt_t, cnt_t>> &count_clauses_with_vars);
 
 
-template<typename num_t, typename cnt_t, typename clause_t>
-num_t read(std::istream& is, std::vector<clause_t> &clauses,
+template<typename num_t, typename cnt_t, typename clause_t, typename clause_storage_t>
+num_t read(std::istream& is, clause_storage_t &clauses,
 	std::vector<std::pair<cnt_t, cnt_t>> &count_clauses_with_vars)
 {
 	// arguments:
@@ -52,9 +244,6 @@ num_t read(std::istream& is, std::vector<clause_t> &clauses,
 	// vector to hold clauses
 	// vector to count how often variables are used (pos/neg)
 	// return number of vars
-	
-	// std::cin.sync_with_stdio(false);
-	// std::cin.tie(0);
 
 	static_assert(std::numeric_limits<num_t>::is_signed);
 	static_assert(std::numeric_limits<num_t>::max() <= std::numeric_limits<std::ptrdiff_t>::max());
@@ -65,58 +254,104 @@ num_t read(std::istream& is, std::vector<clause_t> &clauses,
 	num_t num_vars = 0;
 	num_t num_clauses = 0;
 
-	std::string line;
-	line.reserve(128);
-	std::string field;
-	std::size_t linectr = 0;
+	dimacs_scanner scanner(is);
+	std::vector<num_t> literals; // of the current clause
+	literals.reserve(64);
+	std::size_t num_dropped = 0; // clauses which are always true
 
 	try {
-		while (!is.eof()) {
-			linectr++;
-			
-			std::getline(is, line);
-
-			std::istringstream line_iss(line);
-			
-			switch(line[0]) {
+		for (char c = scanner.skip_whitespace(); 0 != c; c = scanner.skip_whitespace()) {
+			switch (c) {
 				case 'c': // comment
+					scanner.skip_line();
 					break;
 
 				case 'p': // configuration
-					parse_configuration<num_t>(line_iss, line, field, num_vars, num_clauses);
+					parse_configuration<num_t>(scanner, num_vars, num_clauses);
 					clauses.reserve(num_clauses);
 					count_clauses_with_vars.resize(num_vars);
 					break;
 
-				default: // parse clause
-					if (line.empty()) {
+				default: { // literal or end of clause
+					const int64_t literal = scanner.read_integer();
+
+					if (0 == literal) {
+						if (!add_clause<num_t, cnt_t, clause_t>(literals, clauses, count_clauses_with_vars)) {
+							num_dropped++;
+						}
+						literals.clear();
 						break;
 					}
-					
-					parse_clause<num_t, cnt_t, clause_t>(line_iss, line, field, clauses, count_clauses_with_vars, num_vars);
+
+					#if VERIFY_INPUT
+						if (((literal < 0) ? -literal : literal) > num_vars) {
+							throw std::out_of_range("found nonexistent variable in clause");
+						}
+					#endif
+
+					literals.push_back(literal);
 					break;
+				}
 			}
 		}
 
+		if (!literals.empty()) {
+			throw std::runtime_error("invalid format: each clause must be terminated with a 0");
+		}
+
 		#if VERIFY_INPUT
 			assert(std::numeric_limits<std::ptrdiff_t>::max() <= std::numeric_limits<std::size_t>::max());
-			if ((std::size_t) num_clauses != clauses.size()) {
-				#if VERIFY_INPUT && !ALLOW_UNCLEAN_CLAUSES
-					#if DEBUG_OUTPUT
-						std::cout << "some clauses which are always true have been removed" << std::endl;
-					#endif
-				#else
-					throw std::runtime_error("invalid data: number of clauses doesn't match");
-				#endif
+			if ((std::size_t) num_clauses != clauses.size() + num_dropped) {
+				throw std::runtime_error("invalid data: number of clauses doesn't match");
 			}
+
+			#if DEBUG_OUTPUT
+				if (0 < num_dropped) {
+					std::cout << num_dropped << " clauses which are always true have been removed" << std::endl;
+				}
+			#endif
 		#endif
 	} catch (...) {
-		std::throw_with_nested(std::runtime_error("fatal error while reading input, currently parsing in line " + std::to_string(linectr) + ":\n" + field + ""));
+		std::throw_with_nested(std::runtime_error("fatal error while reading input, currently parsing in line " + std::to_string(scanner.get_line())));
 	}
 
 	return num_vars;
 }
 
+// parses comments and the p line, the scanner is at the end of the p line afterwards
+template<typename num_t>
+void parse_header(dimacs_scanner &scanner, num_t &num_vars, num_t &num_clauses) {
+	for (char c = scanner.skip_whitespace(); 0 != c; c = scanner.skip_whitespace()) {
+		if ('c' == c) {
+			scanner.skip_line();
+			continue;
+		}
+
+		if ('p' != c) {
+			throw std::runtime_error("invalid format: expected p line before the first clause");
+		}
+
+		parse_configuration<num_t>(scanner, num_vars, num_clauses);
+		return;
+	}
+
+	throw std::runtime_error("invalid format: no p line found");
+}
+
+void read_header(std::istream& is, int64_t &num_vars, int64_t &num_clauses) {
+	dimacs_scanner scanner(is, 1 << 12);
+	parse_header<int64_t>(scanner, num_vars, num_clauses);
+}
+
+inline std::unique_ptr<std::istream> open_dimacs(const std::string &filename) {
+	const compression type = detect_compression(filename);
+	if (compression::none != type) {
+		return std::make_unique<decompressing_istream>(filename, type);
+	}
+
+	return std::make_unique<std::ifstream>(filename);
+}
+
 template<typename num_t>
 inline void verify_parameter(std::ptrdiff_t tmp) {
 	#if VERIFY_INPUT
@@ -130,124 +365,391 @@ inline void verify_parameter(std::ptrdiff_t tmp) {
 	}
 }
 
+// "p cnf num_vars num_clauses" on one line
 template<typename num_t>
-inline void parse_configuration(std::istringstream &line_iss, std::string &line, std::string &field, num_t &num_vars, num_t &num_clauses) {
-	if (not starts_with(line, "p cnf ")) {
-		throw std::runtime_error("invalid format: expected ' cnf num_vars num_clauses' following 'p'");
+inline void parse_configuration(dimacs_scanner &scanner, num_t &num_vars, num_t &num_clauses) {
+	static const char *format_error = "invalid format: expected ' cnf num_vars num_clauses' following 'p'";
+
+	scanner.advance();
+	if (!scanner.at_blank()) {
+		throw std::runtime_error(format_error);
 	}
+	scanner.skip_blanks();
+	scanner.expect_word("cnf", format_error);
 
-	line_iss >> field;
-	line_iss >> field;
+	num_t *fields[2] = {&num_vars, &num_clauses};
+	for (num_t *field : fields) {
+		if (!scanner.at_blank()) {
+			throw std::runtime_error(format_error);
+		}
 
-	line_iss >> field;
-	std::ptrdiff_t tmp = std::stoll(field);
-	num_vars = tmp;
-	verify_parameter<num_t>(num_vars);
+		const char c = scanner.skip_blanks();
+		if ((0 == c) || ('\n' == c)) {
+			throw std::runtime_error(format_error);
+		}
 
-	line_iss >> field;
-	tmp = std::stoll(field);
-	num_clauses = tmp;
-	verify_parameter<num_t>(num_clauses);
+		std::ptrdiff_t tmp = scanner.read_integer();
+		verify_parameter<num_t>(tmp);
+		*field = tmp;
+	}
 
-	if (not line_iss.eof()) {
+	const char c = scanner.skip_blanks();
+	if ((0 != c) && ('\n' != c)) {
 		throw std::runtime_error("invalid format: too many fields in p line");
 	}
 }
 
-template<typename num_t, typename cnt_t, typename clause_t>
-inline void parse_clause(std::istringstream &line_iss, std::string &line, std::string &field, std::vector<clause_t> &clauses,
-	std::vector<std::pair<cnt_t, cnt_t>> &count_clauses_with_vars, num_t &num_vars)
-{
-	if (not ends_with(line, " 0")) {
-		throw std::runtime_error("invalid format: each clause must be terminated with a 0");
-	}
-
-	line_iss.str(line.substr(0, line.length()-2));
+template<typename num_t>
+inline bool verify_clause(const num_t *literals, const std::size_t n) {
+	#if VERIFY_INPUT
+		if (0 == n) {
+			throw std::runtime_error("each clause must have at least one variable");
+		}
+	#endif
 
-	std::ptrdiff_t nvars = 0;
-	while (not line_iss.eof()) {
-		std::getline(line_iss, field, ' ');
-		std::ptrdiff_t tmp = std::stoll(field);
+	#if VERIFY_INPUT && !ALLOW_UNCLEAN_CLAUSES
+		bool is_unclean = false;
+		bool is_always_true = false;
 
-		#if VERIFY_INPUT
-			if ((0 == tmp) || (llabs(tmp) > num_vars)) {
-				throw std::out_of_range("found nonexistent variable in clause");
+		for (std::size_t i = 0; i < n; i++) {
+			for (std::size_t j = 0; j < i; j++) {
+				if (literals[i] == literals[j]) {
+					is_unclean = true;
+				} else if (literals[i] == -literals[j]) {
+					is_always_true = true;
+				}
 			}
-		#else
-			ignore(num_vars);
-		#endif
-		
-		std::size_t index = llabs(tmp)-1;
+		}
+
+		if (is_always_true) {
+			return false;
+		}
+
+		if (is_unclean) {
+			#if DEBUG_OUTPUT
+				std::cout << "unclean clause: " << clause_view<num_t>(literals, n) << std::endl;
+			#endif
+			throw std::runtime_error("cant process unclean clause!");
+		}
+	#else
+		ignore(literals, n);
+	#endif
+
+	return true;
+}
+
+template<typename num_t, typename cnt_t, typename clause_t, typename clause_storage_t>
+inline bool add_clause(const std::vector<num_t> &literals, clause_storage_t &clauses,
+	std::vector<std::pair<cnt_t, cnt_t>> &count_clauses_with_vars)
+{
+	// a dropped clause isn't counted
+	if (!verify_clause(literals.data(), literals.size())) {
+		return false;
+	}
+
+	for (const num_t literal : literals) {
+		std::size_t index = ((literal < 0) ? -literal : literal) - 1;
 		#if VERIFY_INPUT
 			assert(index < count_clauses_with_vars.size());
 		#endif
 		std::pair<cnt_t, cnt_t> &cnt = count_clauses_with_vars[index];
+		cnt_t &c = (0 > literal) ? cnt.first : cnt.second;
+
+		#if VERIFY_INPUT
+			if (c == std::numeric_limits<cnt_t>::max()) {
+				throw std::out_of_range("read: cnt_t is too small!");
+			}
+		#endif
+		c++;
+	}
+
+	// a flat_clause_storage copies the literals from a view, no clause object is required
+	if constexpr (std::is_same<clause_storage_t, std::vector<clause_t>>::value) {
+		clauses.push_back(clause_t(literals.begin(), literals.end(), literals.size()));
+	} else {
+		clauses.push_back(clause_view<num_t>(literals.data(), literals.size()));
+	}
+
+	return true;
+}
+
+
+inline unsigned& num_parser_threads() {
+	static unsigned num_threads = std::max(1u, std::thread::hardware_concurrency());
+	return num_threads;
+}
+
+// number of line breaks in the first n bytes of the file, only for error messages of the parallel parser
+inline std::size_t count_lines(const std::string &filename, std::size_t n) {
+	std::ifstream filehandle(filename, std::ios::binary);
+	std::vector<char> buffer(1 << 20);
+	std::size_t count = 0;
+
+	while (0 < n) {
+		filehandle.read(buffer.data(), std::min(n, buffer.size()));
+		const std::size_t num_read = filehandle.gcount();
+		if (0 == num_read) {
+			break;
+		}
+		count += std::count(buffer.data(), buffer.data() + num_read, '\n');
+		n -= num_read;
+	}
+
+	return count;
+}
+
+// position after the first line break at or after pos (or the file size), chunks always start at the beginning of a line
+inline std::size_t next_line_start(std::ifstream &filehandle, std::size_t pos, const std::size_t file_size) {
+	char buffer[4096];
+	filehandle.clear();
+	filehandle.seekg(pos);
+
+	while (pos < file_size) {
+		filehandle.read(buffer, sizeof(buffer));
+		const std::size_t num_read = filehandle.gcount();
+		if (0 == num_read) {
+			break;
+		}
+
+		const char *nl = (const char*) std::memchr(buffer, '\n', num_read);
+		if (nullptr != nl) {
+			return pos + (nl - buffer) + 1;
+		}
+		pos += num_read;
+	}
+
+	return file_size;
+}
+
+// literals of a chunk of lines, the last clause may continue in the next chunk
+template<typename num_t>
+struct dimacs_chunk {
+	std::vector<num_t> literals;
+	std::vector<std::size_t> clause_ends; // position in literals after the last literal of each clause
+};
+
+// parses the bytes [first, last) of the file, they have to start at the beginning of a line and end after a line break
+template<typename num_t>
+void parse_dimacs_chunk(const std::string &filename, const std::size_t first, const std::size_t last,
+	const num_t num_vars, dimacs_chunk<num_t> &chunk)
+{
+	std::ifstream filehandle(filename, std::ios::binary);
+	filehandle.seekg(first);
+	dimacs_scanner scanner(filehandle, 1 << 20, last - first);
+
+	try {
+		for (char c = scanner.skip_whitespace(); 0 != c; c = scanner.skip_whitespace()) {
+			if ('c' == c) { // comment
+				scanner.skip_line();
+				continue;
+			}
+
+			if ('p' == c) {
+				throw std::runtime_error("invalid format: more than one p line");
+			}
+
+			const int64_t literal = scanner.read_integer();
+
+			if (0 == literal) {
+				chunk.clause_ends.push_back(chunk.literals.size());
+				continue;
+			}
 
-		if (0 > tmp) {
-			#if VERIFY_INPUT
-				if (cnt.first == std::numeric_limits<cnt_t>::max()) {
-					throw std::out_of_range("read: cnt_t is too small!");
-				}
-			#endif
-			cnt.first++;
-		} else {
 			#if VERIFY_INPUT
-				if (cnt.second == std::numeric_limits<cnt_t>::max()) {
-					throw std::out_of_range("read: cnt_t is too small!");
+				if (((literal < 0) ? -literal : literal) > num_vars) {
+					throw std::out_of_range("found nonexistent variable in clause");
 				}
+			#else
+				ignore(num_vars);
 			#endif
-			cnt.second++;
+
+			chunk.literals.push_back(literal);
 		}
+	} catch (...) {
+		std::throw_with_nested(std::runtime_error("fatal error while reading input, currently parsing in line "
+			+ std::to_string(count_lines(filename, first) + scanner.get_line())));
+	}
+}
+
+template<typename num_t, typename cnt_t, typename clause_t, typename clause_storage_t>
+num_t read_parallel(const std::string &filename, clause_storage_t &clauses,
+	std::vector<std::pair<cnt_t, cnt_t>> &count_clauses_with_vars, const unsigned num_threads)
+{
+	static_assert(std::numeric_limits<num_t>::is_signed);
+	static_assert(std::numeric_limits<num_t>::max() <= std::numeric_limits<std::ptrdiff_t>::max());
+	static_assert(std::numeric_limits<num_t>::min() >= std::numeric_limits<std::ptrdiff_t>::min());
+	static_assert(std::numeric_limits<num_t>::max() <= std::numeric_limits<typename clause_t::num_type>::max());
+	static_assert(std::numeric_limits<num_t>::min() >= std::numeric_limits<typename clause_t::num_type>::min());
+
+	using sum_t = typename clause_storage_t::sum_type;
+
+	const unsigned num_parts = std::max(1u, num_threads);
+	num_t num_vars = 0;
+	num_t num_clauses = 0;
 
-		nvars++;
+	// header and chunks of about the same size which begin at the start of a line
+	std::vector<std::size_t> chunk_start(num_parts + 1);
+	{
+		std::ifstream filehandle(filename, std::ios::binary);
+		if (!filehandle) {
+			throw std::runtime_error("can't open '" + filename + "'");
+		}
+
+		dimacs_scanner scanner(filehandle, 1 << 12);
+		try {
+			parse_header<num_t>(scanner, num_vars, num_clauses);
+		} catch (...) {
+			std::throw_with_nested(std::runtime_error("fatal error while reading input, currently parsing in line " + std::to_string(scanner.get_line())));
+		}
+
+		filehandle.clear();
+		filehandle.seekg(0, std::ios::end);
+		const std::size_t file_size = filehandle.tellg();
+		const std::size_t body_start = scanner.get_offset();
+
+		chunk_start[0] = body_start;
+		for (unsigned part = 1; part < num_parts; part++) {
+			const std::size_t pos = body_start + (file_size - body_start) * part / num_parts;
+			chunk_start[part] = std::max(chunk_start[part-1], next_line_start(filehandle, pos, file_size));
+		}
+		chunk_start[num_parts] = file_size;
 	}
 
+	std::vector<dimacs_chunk<num_t>> chunks(num_parts);
+	parallel_for(num_parts, num_parts, [&](const std::size_t first, const std::size_t last, unsigned) {
+		for (std::size_t c = first; c < last; c++) {
+			parse_dimacs_chunk<num_t>(filename, chunk_start[c], chunk_start[c+1], num_vars, chunks[c]);
+		}
+	});
+
+	// position of the chunks in the merged arrays, a clause spanning chunks is put together by the concatenation
+	std::vector<std::size_t> literal_base(num_parts + 1, 0);
+	std::vector<std::size_t> clause_base(num_parts + 1, 0);
+	for (unsigned c = 0; c < num_parts; c++) {
+		literal_base[c+1] = literal_base[c] + chunks[c].literals.size();
+		clause_base[c+1] = clause_base[c] + chunks[c].clause_ends.size();
+	}
+	const std::size_t num_literals = literal_base[num_parts];
+	const std::size_t num_read = clause_base[num_parts];
+
 	#if VERIFY_INPUT
-		if (1 > nvars) {
-			throw std::runtime_error("each clause must have at least one variable");
+		if (num_literals > (std::size_t) std::numeric_limits<sum_t>::max()) {
+			throw std::out_of_range("flat_clause_storage: sum_t is too small!");
 		}
 	#endif
 
-	line_iss.seekg(0);
-	using it_t = std::istream_iterator<std::ptrdiff_t>;
+	std::vector<num_t> literals(num_literals);
+	std::vector<sum_t> offsets(num_read + 1);
+	offsets[0] = 0;
 
-	auto new_clause = clause_t(it_t(line_iss), it_t(), nvars);
+	parallel_for(num_parts, num_parts, [&](const std::size_t first, const std::size_t last, unsigned) {
+		for (std::size_t c = first; c < last; c++) {
+			std::copy(chunks[c].literals.begin(), chunks[c].literals.end(), literals.begin() + literal_base[c]);
+			for (std::size_t i = 0; i < chunks[c].clause_ends.size(); i++) {
+				offsets[clause_base[c] + i + 1] = literal_base[c] + chunks[c].clause_ends[i];
+			}
+			chunks[c] = dimacs_chunk<num_t>();
+		}
+	});
+
+	// errors which are found after the merge are reported at the end of the file, like read() does
+	auto fail_at_end = [&](const char *error) {
+		try {
+			throw std::runtime_error(error);
+		} catch (...) {
+			std::throw_with_nested(std::runtime_error("fatal error while reading input, currently parsing in line "
+				+ std::to_string(count_lines(filename, chunk_start[num_parts]) + 1)));
+		}
+	};
 
-	#if VERIFY_INPUT && !ALLOW_UNCLEAN_CLAUSES
-		bool is_unclean = false;
-		bool is_always_true = false;
-		
-		for (std::size_t i = 0; i < new_clause.num_vars(); i++) {
-			num_t lit_i = new_clause[i];
-			num_t var_index_i = abs(lit_i)-1;
+	if ((std::size_t) offsets[num_read] != num_literals) {
+		fail_at_end("invalid format: each clause must be terminated with a 0");
+	}
 
-			for (std::size_t j = 0; j < i; j++) {
-				num_t lit_j = new_clause[j];
-				num_t var_index_j = abs(lit_j)-1;
-				
-				if (var_index_i == var_index_j) {
-					if (lit_i == lit_j) {
-						is_unclean = true;
-					} else {
-						is_always_true = true;
-					}
+	// same checks as add_clause(), but for all clauses at once
+	std::vector<char> keep(num_read);
+	std::vector<std::size_t> num_dropped_per_part(num_parts, 0);
+	parallel_for(num_read, num_parts, [&](const std::size_t first, const std::size_t last, const unsigned part) {
+		std::size_t i = first;
+		try {
+			for (; i < last; i++) {
+				keep[i] = verify_clause(literals.data() + offsets[i], offsets[i+1] - offsets[i]);
+				if (!keep[i]) {
+					num_dropped_per_part[part]++;
 				}
 			}
+		} catch (...) {
+			std::throw_with_nested(std::runtime_error("fatal error while reading input, currently checking clause " + std::to_string(i + 1)));
 		}
-
-		if (false == is_always_true) {
-			if (is_unclean) {
-				#if DEBUG_OUTPUT
-					std::cout << "unclean clause " << clauses.size() << ": " << new_clause << std::endl;
-				#endif
-				throw std::runtime_error("cant process unclean clause!");
+	});
+
+	const std::size_t num_dropped = std::accumulate(num_dropped_per_part.begin(), num_dropped_per_part.end(), (std::size_t) 0);
+	if (0 < num_dropped) {
+		// rare, so it's done by one thread
+		std::size_t num_kept = 0;
+		sum_t end = 0;
+		sum_t first = offsets[0];
+		for (std::size_t i = 0; i < num_read; i++) {
+			const sum_t last = offsets[i+1];
+			if (keep[i]) {
+				std::copy(literals.begin() + first, literals.begin() + last, literals.begin() + end);
+				end += last - first;
+				offsets[++num_kept] = end;
 			}
+			first = last;
+		}
+		literals.resize(end);
+		offsets.resize(num_kept + 1);
+	}
 
-			clauses.push_back(new_clause);
+	#if VERIFY_INPUT
+		assert(std::numeric_limits<std::ptrdiff_t>::max() <= std::numeric_limits<std::size_t>::max());
+		if ((std::size_t) num_clauses != num_read) {
+			fail_at_end("invalid data: number of clauses doesn't match");
 		}
-	#else
-		clauses.push_back(new_clause);
+
+		#if DEBUG_OUTPUT
+			if (0 < num_dropped) {
+				std::cout << num_dropped << " clauses which are always true have been removed" << std::endl;
+			}
+		#endif
 	#endif
+
+	// Anzahl negierte/positive Vorkommen je Variable: a histogram per part of the literals, summed up per block of variables,
+	// not more parts than literals per variable so the histograms need about as much memory as the literals
+	const unsigned num_count_parts = (unsigned) std::max<std::size_t>(1, std::min<std::size_t>(num_parts, literals.size() / std::max<std::size_t>(1, num_vars)));
+	std::vector<std::vector<std::size_t>> histogram(num_count_parts);
+	parallel_for(literals.size(), num_count_parts, [&](const std::size_t first, const std::size_t last, const unsigned part) {
+		std::vector<std::size_t> &count = histogram[part];
+		count.assign(2 * (std::size_t) num_vars, 0);
+		for (std::size_t i = first; i < last; i++) {
+			const num_t literal = literals[i];
+			count[2 * (((literal < 0) ? -literal : literal) - 1) + (0 < literal)]++;
+		}
+	});
+
+	count_clauses_with_vars.resize(num_vars);
+	parallel_for(num_vars, num_parts, [&](const std::size_t first, const std::size_t last, unsigned) {
+		for (std::size_t index = first; index < last; index++) {
+			std::size_t negative = 0, positive = 0;
+			for (const std::vector<std::size_t> &count : histogram) {
+				negative += count[2 * index];
+				positive += count[2 * index + 1];
+			}
+
+			#if VERIFY_INPUT
+				if (std::max(negative, positive) > (std::size_t) std::numeric_limits<cnt_t>::max()) {
+					throw std::out_of_range("read: cnt_t is too small!");
+				}
+			#endif
+			count_clauses_with_vars[index] = std::pair<cnt_t, cnt_t>((cnt_t) negative, (cnt_t) positive);
+		}
+	});
+	histogram.clear();
+
+	clauses.assign(std::move(literals), std::move(offsets));
+
+	return num_vars;
 }
 
 
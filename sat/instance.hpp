@@ -8,22 +8,47 @@
 
 #include "random_generator.hpp"
 
-#ifdef USE_BITFIELD
+#if USE_BITFIELD
 	#include "../util/bitfield.hpp"
 #endif
 
+#if USE_SIMD_BREAK_EVAL
+	#include "simd_break_eval.hpp"
+#endif
+
 
 // Macros used:
 // USE_BITFIELD - wheter to use a bitfield to store the current cnf formula assignment
 // USE_CRIT_LITERAL_CACHING - wheter to cache the critical literal in a clause
+// USE_INTERLEAVED_VAR_STATE - wheter to store the state of a variable in one record (requires USE_CONT_DATASTRUCT)
+// USE_PACKED_CLAUSE_STATE - wheter to store the state of a clause in one record (requires USE_CRIT_LITERAL_CACHING)
+// USE_SIMD_BREAK_EVAL - wheter to evaluate the probability function for wide clauses with AVX2 / AVX-512
+// TRACK_BEST_ASSIGNMENT - wheter to remember the assignment with the least unsatisfied clauses
 // ADDITIONAL_CHECKS - additional sanity checks used while developing to ensure correctness
 // ALLOW_UNCLEAN_CLAUSES - wheter a literal may appear multiple times in a clause
 // DEBUG_OUTPUT - for development
 
+#if USE_INTERLEAVED_VAR_STATE && !USE_CONT_DATASTRUCT
+	#error "USE_INTERLEAVED_VAR_STATE requires USE_CONT_DATASTRUCT"
+#endif
+
+#if USE_PACKED_CLAUSE_STATE && !USE_CRIT_LITERAL_CACHING
+	#error "USE_PACKED_CLAUSE_STATE requires USE_CRIT_LITERAL_CACHING"
+#endif
+
+
+// strategy used to select the next unsatisfied clause
+enum class clause_pick_policy {
+	uniform, // uniform random choice as assumed in the ProbSAT paper
+	round_robin, // walk through the list of unsatisfied clauses
+	flip_modulo // unsat_clauses[num_flips % num_unsat_clauses] as in Adrian Balint's implementation
+};
+
 
 #if __cplusplus > 201703L
 template<typename num_t, typename sum_t, typename cnt_t, typename prec_t,
-	class clause_t, class prob_func_t, class random_generator_t, bool caching>
+	class clause_t, class prob_func_t, class random_generator_t, bool caching,
+	clause_pick_policy pick_policy = clause_pick_policy::flip_modulo>
 	requires (
 		clause_t::is_clause_t
 		&& prob_func_t::is_prob_func_impl_t
@@ -31,7 +56,8 @@ template<typename num_t, typename sum_t, typename cnt_t, typename prec_t,
 		&& random_generator_t::is_random_generator_impl_t)
 #else
 template<typename num_t, typename sum_t, typename cnt_t, typename prec_t,
-	class clause_t, class prob_func_t, class random_generator_t, bool caching, 
+	class clause_t, class prob_func_t, class random_generator_t, bool caching,
+	clause_pick_policy pick_policy = clause_pick_policy::flip_modulo,
 	bool requires = // requires keyword is c++20 code...
 		( clause_t::is_clause_t
 		&& prob_func_t::is_prob_func_impl_t
@@ -41,51 +67,123 @@ template<typename num_t, typename sum_t, typename cnt_t, typename prec_t,
 class serial_instance {
 	private:
 		using cnf_formula_t = cnf_formula<num_t, sum_t, cnt_t, clause_t>;
+		using clause_view_t = typename cnf_formula_t::clause_view_t;
 		const cnf_formula_t &bformula; // cnf formula
 
-		#ifdef USE_BITFIELD
+		#if USE_BITFIELD
 			using belegung_t = bitfield<num_t>;
 		#else
 			using belegung_t = std::vector<bool>;
 		#endif
 
-		belegung_t belegung; // current variable configuration
+		#if USE_INTERLEAVED_VAR_STATE
+			// everything flip_literal needs to know about a variable in one record
+			struct alignas(16) variable_state {
+				sum_t offset; // offset in clauses_with_vars of the formula
+				cnt_t neg_count; // number of clauses with the negative literal
+				cnt_t pos_count; // number of clauses with the positive literal
+				cnt_t num_breaks; // number of breaked clauses by flip of variable
+				bool value; // current variable configuration
+			};
+
+			std::vector<variable_state> variables;
+			const num_t *clauses_with_vars = nullptr; // owned by bformula
+			mutable belegung_t belegung; // initial configuration, only updated in get_assignment
+		#else
+			belegung_t belegung; // current variable configuration
+		#endif
+
 		std::vector<num_t> unsat_clauses; // list of unsatisfied clause indices
-		std::vector<num_t> unsat_clauses_location; // maps clause_index to location in unsat_clauses
-		// if a clause is satisfied, location is negative count of satisfied literals in clause
+
+		#if USE_PACKED_CLAUSE_STATE
+			// everything a break or make step needs to know about a clause in one record
+			struct clause_state {
+				num_t location; // location in unsat_clauses, if satisfied negative count of satisfied literals
+				num_t crit_literal; // critical variable, valid if exactly one literal is satisfied
+			};
+
+			std::vector<clause_state> clause_states;
+		#else
+			std::vector<num_t> unsat_clauses_location; // maps clause_index to location in unsat_clauses
+			// if a clause is satisfied, location is negative count of satisfied literals in clause
+		#endif
 
 		std::size_t num_flips_done = 0;
+		std::size_t pick_position = 0; // used by clause_pick_policy::round_robin
+
+		std::vector<prec_t> f; // prefix sums of f(num_breaks) for the literals of the random clause in do_flip
+
+		#if TRACK_BEST_ASSIGNMENT
+			// the best assignment is the current one with the variables in best_trail flipped back
+			// if the trail gets longer than the number of variables the best assignment is copied once
+			std::size_t min_num_unsat = 0; // since the last reset / perturbation
+			std::size_t min_num_unsat_flips = 0; // num_flips_done when min_num_unsat was reached
+			std::vector<num_t> best_trail; // variables flipped since the best assignment
+			bool best_copied = false; // best_trail is not recorded any more, best_belegung is valid
+			belegung_t best_belegung;
+
+			void start_best_tracking(); // the current assignment is the best one
+			void update_best(const num_t flipped_var_index);
+			void copy_best();
+		#endif
 
 		// data used for caching:
-		std::vector<cnt_t> num_breaks_by_flip; // number of breaked clauses by flip of variable
+		#if !USE_INTERLEAVED_VAR_STATE
+			std::vector<cnt_t> num_breaks_by_flip; // number of breaked clauses by flip of variable
+		#endif
 
-		#if USE_CRIT_LITERAL_CACHING
+		#if USE_CRIT_LITERAL_CACHING && !USE_PACKED_CLAUSE_STATE
 			std::vector<num_t> crit_literal_in_clause; // critical variable in each clause
 		#endif
 
+		#if USE_SIMD_BREAK_EVAL && !USE_INTERLEAVED_VAR_STATE
+			// the kernels read the cached break counts and the table of the probability function directly
+			static constexpr bool simd_break_eval = caching
+				&& has_prob_func_table<prob_func_t>::value
+				&& std::is_same<prec_t, double>::value
+				&& simd_break_eval_supported<num_t, cnt_t>()
+				&& ((0 == clause_view_t::static_width) || (SIMD_BREAK_EVAL_MIN_WIDTH <= clause_view_t::static_width));
+			simd_level simd = simd_level::scalar; // instruction set used in do_flip
+		#endif
+
 		prob_func_t &pfi;
 		random_generator_t &rgenerator;
 		
 
+		// access to the state of a variable, independent of the memory layout
+		bool get_value(const num_t var_index) const;
+		void flip_value(const num_t var_index);
+		cnt_t& num_breaks_of(const num_t var_index);
+		cnt_t num_breaks_of(const num_t var_index) const;
+		auto get_iterators_for_clauses_with_vars(const num_t var_index) const;
+
+		// access to the state of a clause, independent of the memory layout
+		num_t& location_of(const num_t clause_index);
+		num_t& crit_literal_of(const num_t clause_index);
+
 		void make_clause_unsat(const num_t clause_index);
 		void make_clause_sat(const num_t clause_index);
 
 		cnt_t get_num_breaks_by_flip(num_t literal, const bool caching_ = caching) const;
 
 		prec_t calc_f(num_t num_breaks);
-		num_t get_index_of_random_unsatisfied_clause() const;
+		// vectorized variants of the two loops in do_flip, return false if not applicable
+		bool calc_sum_f_simd(const clause_view_t clause, prec_t *f, prec_t &sum_f) const;
+		bool pick_literal_simd(const clause_view_t clause, const prec_t *f, const prec_t r, num_t &rlit) const;
+		num_t get_index_of_random_unsatisfied_clause();
 		prec_t get_random_value(prec_t l) const;
 
-		bool is_clause_satisfied(const clause_t &clause) const;
-		num_t get_critical_literal(const clause_t &clause, const num_t dont_take_literal = 0) const;
-		num_t get_first_satisfied_literal(const clause_t &clause, const num_t dont_take_literal = 0) const;
+		bool is_clause_satisfied(const clause_view_t clause) const;
+		num_t get_critical_literal(const clause_view_t clause, const num_t dont_take_literal = 0) const;
+		num_t get_first_satisfied_literal(const clause_view_t clause, const num_t dont_take_literal = 0) const;
 		
-		auto num_sat_lit_in_clause(const clause_t &clause) const;
+		auto num_sat_lit_in_clause(const clause_view_t clause) const;
 		auto get_num_sat_lit_in_clause(const num_t clause_index) const;
 
 		void flip_literal(num_t literal);
 
-		void initialize();
+		void initialize(); // allocates all buffers
+		void initialize_state(); // unsat list, break counts and critical literals of the current assignment
 
 	public:
 
@@ -93,13 +191,29 @@ class serial_instance {
 		serial_instance(const serial_instance&) = delete; // no copy constructor!
 
 		void do_flip();
+		std::size_t do_flips(const std::size_t n); // at most n flips, stops if a solution is found, returns the flips done
 		bool found_solution() const;
 		bool check_assignment() const;
 
+		// starts a new try with another assignment, the buffers are reused (no allocations)
+		// the random generator is owned by the caller and reseeded there
+		void reset(const belegung_t &new_config);
+		// starts a new try from the current assignment with about fraction * num_vars random variables flipped
+		// updated incrementally by flip_literal, so the costs depend only on the occurrences of these variables
+		void perturb(const double fraction);
+
+		#if TRACK_BEST_ASSIGNMENT
+			std::size_t get_min_number_of_unsat_clauses() const;
+			std::size_t get_min_number_of_unsat_clauses_flips() const; // flips done when the minimum was reached
+			belegung_t get_best_assignment() const;
+			void restore_best(); // continues with the best assignment (incremental if the trail is short)
+		#endif
+
 		auto get_number_of_unsat_clauses();
 		std::size_t get_num_flips();
 
 		using configuration_type = belegung_t;
+		const configuration_type& get_assignment() const; // current assignment, e.g. to output a solution
 };
 
 
@@ -108,24 +222,117 @@ class serial_instance {
 // *********************************************************************
 
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <tuple>
 #include <type_traits>
 
 #if __cplusplus > 201703L
 	#define INSTANCE_TEMPLATE_ template<typename num_t, typename sum_t, \
-		typename cnt_t, typename prec_t, class clause_t, class prob_func_t, class random_generator_t, bool caching>
-	#define INSTANCE_CLASS_ serial_instance<num_t, sum_t, cnt_t, prec_t, clause_t, prob_func_t, random_generator_t, caching>
+		typename cnt_t, typename prec_t, class clause_t, class prob_func_t, class random_generator_t, bool caching, \
+		clause_pick_policy pick_policy>
+	#define INSTANCE_CLASS_ serial_instance<num_t, sum_t, cnt_t, prec_t, clause_t, prob_func_t, random_generator_t, caching, pick_policy>
 #else
 	#define INSTANCE_TEMPLATE_ template<typename num_t, typename sum_t,  \
-		typename cnt_t, typename prec_t, class clause_t, class prob_func_t, class random_generator_t, bool caching, bool requires>
-	#define INSTANCE_CLASS_ serial_instance<num_t, sum_t, cnt_t, prec_t, clause_t, prob_func_t, random_generator_t, caching, requires>
+		typename cnt_t, typename prec_t, class clause_t, class prob_func_t, class random_generator_t, bool caching, \
+		clause_pick_policy pick_policy, bool requires>
+	#define INSTANCE_CLASS_ serial_instance<num_t, sum_t, cnt_t, prec_t, clause_t, prob_func_t, random_generator_t, caching, pick_policy, requires>
+#endif
+
+
+#if USE_INTERLEAVED_VAR_STATE
+
+	INSTANCE_TEMPLATE_
+	inline bool INSTANCE_CLASS_::get_value(const num_t var_index) const {
+		return variables[var_index].value;
+	}
+
+	INSTANCE_TEMPLATE_
+	inline void INSTANCE_CLASS_::flip_value(const num_t var_index) {
+		variables[var_index].value = !variables[var_index].value;
+	}
+
+	INSTANCE_TEMPLATE_
+	inline cnt_t& INSTANCE_CLASS_::num_breaks_of(const num_t var_index) {
+		return variables[var_index].num_breaks;
+	}
+
+	INSTANCE_TEMPLATE_
+	inline cnt_t INSTANCE_CLASS_::num_breaks_of(const num_t var_index) const {
+		return variables[var_index].num_breaks;
+	}
+
+	INSTANCE_TEMPLATE_
+	inline auto INSTANCE_CLASS_::get_iterators_for_clauses_with_vars(const num_t var_index) const {
+		const variable_state &vs = variables[var_index];
+		const num_t *neg_start = clauses_with_vars + vs.offset;
+		const num_t *pos_start = neg_start + vs.neg_count;
+		return std::make_tuple(neg_start, pos_start, pos_start, pos_start + vs.pos_count);
+	}
+
+#else
+
+	INSTANCE_TEMPLATE_
+	inline bool INSTANCE_CLASS_::get_value(const num_t var_index) const {
+		return belegung[var_index];
+	}
+
+	INSTANCE_TEMPLATE_
+	inline void INSTANCE_CLASS_::flip_value(const num_t var_index) {
+		belegung[var_index].flip();
+	}
+
+	INSTANCE_TEMPLATE_
+	inline cnt_t& INSTANCE_CLASS_::num_breaks_of(const num_t var_index) {
+		return num_breaks_by_flip[var_index];
+	}
+
+	INSTANCE_TEMPLATE_
+	inline cnt_t INSTANCE_CLASS_::num_breaks_of(const num_t var_index) const {
+		return num_breaks_by_flip[var_index];
+	}
+
+	INSTANCE_TEMPLATE_
+	inline auto INSTANCE_CLASS_::get_iterators_for_clauses_with_vars(const num_t var_index) const {
+		return bformula.get_iterators_for_clauses_with_vars(var_index);
+	}
+
+#endif
+
+
+#if USE_PACKED_CLAUSE_STATE
+
+	INSTANCE_TEMPLATE_
+	inline num_t& INSTANCE_CLASS_::location_of(const num_t clause_index) {
+		return clause_states[clause_index].location;
+	}
+
+	INSTANCE_TEMPLATE_
+	inline num_t& INSTANCE_CLASS_::crit_literal_of(const num_t clause_index) {
+		return clause_states[clause_index].crit_literal;
+	}
+
+#else
+
+	INSTANCE_TEMPLATE_
+	inline num_t& INSTANCE_CLASS_::location_of(const num_t clause_index) {
+		return unsat_clauses_location[clause_index];
+	}
+
+	#if USE_CRIT_LITERAL_CACHING
+		INSTANCE_TEMPLATE_
+		inline num_t& INSTANCE_CLASS_::crit_literal_of(const num_t clause_index) {
+			return crit_literal_in_clause[clause_index];
+		}
+	#endif
+
 #endif
 
 
 INSTANCE_TEMPLATE_
 void INSTANCE_CLASS_::make_clause_unsat(const num_t clause_index) {
-	unsat_clauses_location[clause_index] = unsat_clauses.size();
+	location_of(clause_index) = unsat_clauses.size();
 	unsat_clauses.push_back(clause_index);
 
 	#if DEBUG_OUTPUT
@@ -137,13 +344,13 @@ void INSTANCE_CLASS_::make_clause_unsat(const num_t clause_index) {
 
 INSTANCE_TEMPLATE_
 void INSTANCE_CLASS_::make_clause_sat(const num_t clause_index) {
-	num_t now_sat_cl = unsat_clauses_location[clause_index];
+	num_t now_sat_cl = location_of(clause_index);
 
 	// clause must be in unsat list!
 	assert((0 == ADDITIONAL_CHECKS) || (0 <= now_sat_cl));
 	assert((0 == ADDITIONAL_CHECKS) || (clause_index == unsat_clauses[now_sat_cl]));
 	
-	unsat_clauses_location[clause_index] = -1;
+	location_of(clause_index) = -1;
 
 	#if DEBUG_OUTPUT
 		std::cout << "make_clause_sat: clause " << clause_index << " is now sat" << std::endl;
@@ -174,7 +381,7 @@ void INSTANCE_CLASS_::make_clause_sat(const num_t clause_index) {
 
 	assert((0 == ADDITIONAL_CHECKS) || ((std::size_t) now_sat_cl < unsat_clauses.size()));
 
-	unsat_clauses_location[uclause] = now_sat_cl;
+	location_of(uclause) = now_sat_cl;
 	unsat_clauses[now_sat_cl] = uclause;
 }
 
@@ -187,18 +394,18 @@ cnt_t INSTANCE_CLASS_::get_num_breaks_by_flip(num_t literal, const bool caching_
 		#if DEBUG_OUTPUT
 			std::cout << "literal: " << literal
 				<< ", ref num breaks: " << get_num_breaks_by_flip(literal, false)
-				<< ", cache: " << num_breaks_by_flip[var_index] << std::endl;
+				<< ", cache: " << num_breaks_of(var_index) << std::endl;
 		#endif
 
 		#if ADDITIONAL_CHECKS
-			assert(get_num_breaks_by_flip(literal, false) == num_breaks_by_flip[var_index]);
+			assert(get_num_breaks_by_flip(literal, false) == num_breaks_of(var_index));
 		#endif
 
-		return num_breaks_by_flip[var_index];
+		return num_breaks_of(var_index);
 	} else {
 		cnt_t num_breaks = 0;
 
-		auto it_tuple = bformula.get_iterators_for_clauses_with_vars(var_index);
+		auto it_tuple = get_iterators_for_clauses_with_vars(var_index);
 		auto it_start = std::get<2>(it_tuple);
 		auto it_end = std::get<3>(it_tuple);
 		if (0 < literal) {
@@ -227,9 +434,67 @@ prec_t INSTANCE_CLASS_::calc_f(num_t num_breaks) {
 
 
 INSTANCE_TEMPLATE_
-num_t INSTANCE_CLASS_::get_index_of_random_unsatisfied_clause() const {
-	auto ri = num_flips_done % unsat_clauses.size();
-	return unsat_clauses[ri];
+inline bool INSTANCE_CLASS_::calc_sum_f_simd(const clause_view_t clause, prec_t *f, prec_t &sum_f) const {
+	#if USE_SIMD_BREAK_EVAL && !USE_INTERLEAVED_VAR_STATE
+		if constexpr (simd_break_eval) {
+			const std::size_t n = clause.num_vars();
+			if ((simd_level::scalar != simd) && (SIMD_BREAK_EVAL_MIN_WIDTH <= n)) {
+				gather_break_probabilities(simd, clause.begin(), n, num_breaks_by_flip.data(), pfi.data(), f);
+
+				// the prefix sum stays sequential, so f and the chosen literal are bit identical to the scalar loop
+				for (std::size_t i = 0; i < n; i++) {
+					assert((0 == ADDITIONAL_CHECKS) || (pfi.calc_prob_function(get_num_breaks_by_flip(clause[i])) == f[i]));
+					sum_f += f[i];
+					f[i] = sum_f;
+				}
+				return true;
+			}
+		}
+	#endif
+
+	ignore(clause, f, &sum_f);
+	return false;
+}
+
+
+INSTANCE_TEMPLATE_
+inline bool INSTANCE_CLASS_::pick_literal_simd(const clause_view_t clause, const prec_t *f, const prec_t r, num_t &rlit) const {
+	#if USE_SIMD_BREAK_EVAL && !USE_INTERLEAVED_VAR_STATE
+		if constexpr (simd_break_eval) {
+			const std::size_t n = clause.num_vars();
+			if ((simd_level::scalar != simd) && (SIMD_BREAK_EVAL_MIN_WIDTH <= n)) {
+				const std::size_t i = find_first_greater(simd, f, n, r);
+				assert((0 == ADDITIONAL_CHECKS) || (i < n));
+				rlit = clause[i];
+				return true;
+			}
+		}
+	#endif
+
+	ignore(clause, f, r, &rlit);
+	return false;
+}
+
+
+INSTANCE_TEMPLATE_
+num_t INSTANCE_CLASS_::get_index_of_random_unsatisfied_clause() {
+	const std::size_t num_unsat = unsat_clauses.size();
+
+	if constexpr (clause_pick_policy::uniform == pick_policy) {
+		// scale instead of modulo to avoid a bias towards the front of the list
+		const uint64_t r = rgenerator.rand();
+		const uint64_t range = (uint64_t) rgenerator.get_rand_max() + 1u;
+		return unsat_clauses[(r * num_unsat) / range];
+	} else if constexpr (clause_pick_policy::round_robin == pick_policy) {
+		pick_position++;
+		if (pick_position >= num_unsat) {
+			pick_position = 0;
+		}
+		return unsat_clauses[pick_position];
+	} else {
+		auto ri = num_flips_done % num_unsat;
+		return unsat_clauses[ri];
+	}
 }
 
 
@@ -242,45 +507,51 @@ prec_t INSTANCE_CLASS_::get_random_value(prec_t l) const {
 
 
 INSTANCE_TEMPLATE_
-bool INSTANCE_CLASS_::is_clause_satisfied(const clause_t &clause) const {
+bool INSTANCE_CLASS_::is_clause_satisfied(const clause_view_t clause) const {
 	return (0 != get_first_satisfied_literal(clause));
 }
 
 
 INSTANCE_TEMPLATE_
-inline num_t INSTANCE_CLASS_::get_critical_literal(const clause_t &clause, const num_t dont_take_literal) const {
+inline num_t INSTANCE_CLASS_::get_critical_literal(const clause_view_t clause, const num_t dont_take_literal) const {
 	return get_first_satisfied_literal(clause, dont_take_literal);
 }
 
 
 INSTANCE_TEMPLATE_
-inline num_t INSTANCE_CLASS_::get_first_satisfied_literal(const clause_t &clause, const num_t dont_take_literal) const {
-	for (std::size_t i = 0; i < clause.num_vars(); i++) {
+inline num_t INSTANCE_CLASS_::get_first_satisfied_literal(const clause_view_t clause, const num_t dont_take_literal) const {
+	num_t sat_lit = 0;
+	clause.for_each_index([&](const std::size_t i) {
 		num_t lit = clause[i];
 
 		if (dont_take_literal != lit) {
 			num_t var_index = abs(lit)-1;
-			bool value = belegung[var_index];
+			bool value = get_value(var_index);
 
-			if ((0 > lit) ^ value)
-				return lit; // at least this literal is satisfied
+			if ((0 > lit) ^ value) {
+				sat_lit = lit; // at least this literal is satisfied
+				return false;
+			}
 		}
-	}
+
+		return true;
+	});
 	
-	return 0;
+	return sat_lit;
 }
 
 
 INSTANCE_TEMPLATE_
-auto INSTANCE_CLASS_::num_sat_lit_in_clause(const clause_t &clause) const {
+auto INSTANCE_CLASS_::num_sat_lit_in_clause(const clause_view_t clause) const {
 	auto n = 0;
-	for (std::size_t i = 0; i < clause.num_vars(); i++) {
+	clause.for_each_index([&](const std::size_t i) {
 		num_t lit = clause[i];
 		num_t var_index = abs(lit)-1;
-		const bool value = belegung[var_index];
+		const bool value = get_value(var_index);
 
 		if ((0 > lit) ^ value) { n++; }
-	}
+		return true;
+	});
 	
 	return n;
 }
@@ -288,7 +559,7 @@ auto INSTANCE_CLASS_::num_sat_lit_in_clause(const clause_t &clause) const {
 
 INSTANCE_TEMPLATE_
 auto INSTANCE_CLASS_::get_num_sat_lit_in_clause(const num_t clause_index) const {
-	return num_sat_lit_in_clause(bformula.get_clause(clause_index));
+	return num_sat_lit_in_clause(bformula.get_clause_view(clause_index));
 }
 
 
@@ -301,7 +572,7 @@ void INSTANCE_CLASS_::flip_literal(num_t literal) {
 	#endif
 
 	// Liste der unerfüllten Klauseln aktualisieren
-	auto it_tuple_tmp = bformula.get_iterators_for_clauses_with_vars(rvar_index);
+	auto it_tuple_tmp = get_iterators_for_clauses_with_vars(rvar_index);
 	auto it_tuple = it_tuple_tmp; // first iterator pair of it_tuple is list of negative literals, second pair is for positive literals
 	if (0 < literal) {
 		// an unsat literal greater zero means the variable was false and is now flipped to true
@@ -319,7 +590,7 @@ void INSTANCE_CLASS_::flip_literal(num_t literal) {
 	for (auto it = std::get<0>(it_tuple); it != std::get<1>(it_tuple); it++) {
 		num_t clause_index = *it;
 
-		num_t ucl = unsat_clauses_location[clause_index];
+		num_t ucl = location_of(clause_index);
 
 		if (0 <= ucl) {
 			// clause is already in unsat list, nothing to do
@@ -332,42 +603,42 @@ void INSTANCE_CLASS_::flip_literal(num_t literal) {
 
 				if (caching) {
 					// the current variable may not break a clause any more if flipped
-					num_breaks_by_flip[rvar_index]--;
+					num_breaks_of(rvar_index)--;
 				}
 
 				#if USE_CRIT_LITERAL_CACHING // && ALLOW_UNCLEAN_CLAUSES
-					crit_literal_in_clause[clause_index] = 0;
+					crit_literal_of(clause_index) = 0;
 				#endif
 			} else {
 				// one satisfied literal less in clause
-				unsat_clauses_location[clause_index]++;
+				location_of(clause_index)++;
 			}
 
 			if (caching) {
 				if (-2 == ucl) {
 					// as only one literal is left, it may break this clause now if flipped
-					num_t crit_literal = get_critical_literal(bformula.get_clause(clause_index), -literal);
+					num_t crit_literal = get_critical_literal(bformula.get_clause_view(clause_index), -literal);
 					// crit_literal shall not choose -literal (bit not yet flipped: literal = unsat => -literal = sat)
 					
 					#if ALLOW_UNCLEAN_CLAUSES
 						if (0 == crit_literal) {
 							// found no critical literal -> so it's an unclean clause with one "-literal" left
-							num_breaks_by_flip[rvar_index]++;
+							num_breaks_of(rvar_index)++;
 							// temporarily increment num_breaks_by_flip - it will be decremented in case (-1 == ucl)
 							#if USE_CRIT_LITERAL_CACHING
-								crit_literal_in_clause[clause_index] = -literal;
+								crit_literal_of(clause_index) = -literal;
 							#endif
 						} else {
-							num_breaks_by_flip[abs(crit_literal) - 1]++;
+							num_breaks_of(abs(crit_literal) - 1)++;
 							#if USE_CRIT_LITERAL_CACHING
-								crit_literal_in_clause[clause_index] = crit_literal;
+								crit_literal_of(clause_index) = crit_literal;
 							#endif
 						}
 					#else
 						assert((0 == ADDITIONAL_CHECKS) || (0 != crit_literal));
-						num_breaks_by_flip[abs(crit_literal) - 1]++;
+						num_breaks_of(abs(crit_literal) - 1)++;
 						#if USE_CRIT_LITERAL_CACHING
-							crit_literal_in_clause[clause_index] = crit_literal;
+							crit_literal_of(clause_index) = crit_literal;
 						#endif
 					#endif
 				}
@@ -379,7 +650,7 @@ void INSTANCE_CLASS_::flip_literal(num_t literal) {
 	for (auto it = std::get<2>(it_tuple); it != std::get<3>(it_tuple); it++) {
 		num_t clause_index = *it;
 
-		num_t ucl = unsat_clauses_location[clause_index];
+		num_t ucl = location_of(clause_index);
 
 		if (0 <= ucl) {
 			// clause was in unsat list, make it satisfied
@@ -387,23 +658,23 @@ void INSTANCE_CLASS_::flip_literal(num_t literal) {
 
 			if (caching) {
 				// the current variable may now break a clause if flipped again
-				num_breaks_by_flip[rvar_index]++;
+				num_breaks_of(rvar_index)++;
 			}
 
 			#if USE_CRIT_LITERAL_CACHING
-				crit_literal_in_clause[clause_index] = literal;
+				crit_literal_of(clause_index) = literal;
 			#endif
 		} else {
 			// clause is already satisfied
 			
 			// increment number of satisfied literals by one (counter is negative!)
-			unsat_clauses_location[clause_index]--;
+			location_of(clause_index)--;
 
 			if (caching) {
 				if (-1 == ucl) {
 					#if USE_CRIT_LITERAL_CACHING
-						num_t crit_literal = crit_literal_in_clause[clause_index];
-						num_t reference = get_critical_literal(bformula.get_clause(clause_index), -literal);
+						num_t crit_literal = crit_literal_of(clause_index);
+						num_t reference = get_critical_literal(bformula.get_clause_view(clause_index), -literal);
 						#if DEBUG_OUTPUT
 							std::cout << "USE_CRIT_LITERAL_CACHING: " << crit_literal
 								<< ", reference: " << reference << std::endl;
@@ -411,24 +682,24 @@ void INSTANCE_CLASS_::flip_literal(num_t literal) {
 						assert((0 == ADDITIONAL_CHECKS) || (crit_literal == reference) || (crit_literal == literal));
 					#else
 						// this clause had a critical literal and now won't break any more by only one flip
-						num_t crit_literal = get_critical_literal(bformula.get_clause(clause_index), -literal);
+						num_t crit_literal = get_critical_literal(bformula.get_clause_view(clause_index), -literal);
 						// crit_literal shall not choose -literal (bit not yet flipped: literal = unsat => -literal = sat)
 					#endif
 
 					#if ALLOW_UNCLEAN_CLAUSES
 						if (0 == crit_literal) {
 							// if we can't find a critical literal, it's an unclean clause
-							num_breaks_by_flip[rvar_index]--;
+							num_breaks_of(rvar_index)--;
 						} else {
-							num_breaks_by_flip[abs(crit_literal) - 1]--;
+							num_breaks_of(abs(crit_literal) - 1)--;
 						}
 
 						#if USE_CRIT_LITERAL_CACHING
-							crit_literal_in_clause[clause_index] = 0;
+							crit_literal_of(clause_index) = 0;
 						#endif
 					#else
 						assert((0 == ADDITIONAL_CHECKS) || (0 != crit_literal));
-						num_breaks_by_flip[abs(crit_literal) - 1]--;
+						num_breaks_of(abs(crit_literal) - 1)--;
 					#endif
 				}
 			}
@@ -436,12 +707,11 @@ void INSTANCE_CLASS_::flip_literal(num_t literal) {
 	}
 
 	// flip (must be done after make, so get_critical_literal in case of caching works correctly)
-	bool value = belegung[rvar_index];
-	belegung[rvar_index] = !value;
+	flip_value(rvar_index);
 
 	#if DEBUG_OUTPUT
 		std::cout << "flipped literal " << literal << " (var_index = " << rvar_index << ")" 
-			<< " from " << (value ? "1": "0") << " to " << (belegung[rvar_index] ? "1" : "0") << std::endl;
+			<< " to " << (get_value(rvar_index) ? "1" : "0") << std::endl;
 	#endif
 }
 
@@ -458,22 +728,66 @@ void INSTANCE_CLASS_::initialize() {
 	// unsat_clauses may also grow dynamically so this is not really necessary but might be better for performance
 	unsat_clauses.reserve(num_clauses);
 
+	// required, do_flip writes f[i] for every literal of a clause
+	f.resize(bformula.get_max_clause_width());
+
 	// required:
-	unsat_clauses_location.reserve(num_clauses);
+	#if USE_PACKED_CLAUSE_STATE
+		clause_states.resize(num_clauses);
+	#else
+		unsat_clauses_location.resize(num_clauses);
+	#endif
 	if (caching) {
 		#if DEBUG_OUTPUT
 			std::cout << "use caching!" << std::endl;
 		#endif
-		num_breaks_by_flip.resize(bformula.num_vars());
+		#if !USE_INTERLEAVED_VAR_STATE
+			// one more element, the avx kernels read 16 bit counts as 32 bit values
+			num_breaks_by_flip.resize(bformula.num_vars() + 1);
+		#endif
 		//f_cache.resize(bformula.get_max_num_breaks_possible()+1);
 	}
 
-	#if USE_CRIT_LITERAL_CACHING
+	#if USE_CRIT_LITERAL_CACHING && !USE_PACKED_CLAUSE_STATE
 		crit_literal_in_clause.resize(num_clauses);
 	#endif
 
+	#if USE_INTERLEAVED_VAR_STATE
+		// copy the occurrence offsets of the formula into the records
+		clauses_with_vars = bformula.get_clauses_with_vars();
+		variables.resize(bformula.num_vars());
+		for (num_t var_index = 0; var_index < bformula.num_vars(); var_index++) {
+			const std::pair<sum_t, cnt_t> oo = bformula.get_occurrence_offset(var_index);
+			variable_state &vs = variables[var_index];
+			vs.offset = oo.first;
+			vs.neg_count = oo.second;
+			vs.pos_count = bformula.get_occurrence_offset(var_index + 1).first - oo.first - oo.second;
+		}
+	#endif
+
 	pfi.set_max_num_breaks_possible(bformula.get_max_num_breaks_possible());
 
+	initialize_state();
+}
+
+
+INSTANCE_TEMPLATE_
+void INSTANCE_CLASS_::initialize_state() {
+	auto num_clauses = bformula.num_clauses();
+
+	unsat_clauses.clear();
+	num_flips_done = 0;
+	pick_position = 0;
+
+	#if USE_INTERLEAVED_VAR_STATE
+		for (num_t var_index = 0; var_index < bformula.num_vars(); var_index++) {
+			variables[var_index].num_breaks = 0;
+			variables[var_index].value = belegung[var_index];
+		}
+	#else
+		std::fill(num_breaks_by_flip.begin(), num_breaks_by_flip.end(), 0);
+	#endif
+
 	for (num_t clause_index = 0; clause_index < num_clauses; clause_index++) {
 		auto num_sat_lit = get_num_sat_lit_in_clause(clause_index);
 		switch (num_sat_lit) {
@@ -482,20 +796,30 @@ void INSTANCE_CLASS_::initialize() {
 				break;
 			case 1:
 				if (caching) {
-					num_t crit_literal = get_critical_literal(bformula.get_clause(clause_index));
-					num_breaks_by_flip[abs(crit_literal) - 1]++;
+					num_t crit_literal = get_critical_literal(bformula.get_clause_view(clause_index));
+					num_breaks_of(abs(crit_literal) - 1)++;
 
 					// TODO: make caching compatible with ALLOW_UNCLEAN_CLAUSES...
 
 					#if USE_CRIT_LITERAL_CACHING
-						crit_literal_in_clause[clause_index] = crit_literal;
+						crit_literal_of(clause_index) = crit_literal;
 					#endif
 				}
 				[[fallthrough]];
 			default:
-				unsat_clauses_location[clause_index] = -num_sat_lit;
+				location_of(clause_index) = -num_sat_lit;
 		}
+
+		#if USE_CRIT_LITERAL_CACHING
+			if ((!caching) || (1 != num_sat_lit)) {
+				crit_literal_of(clause_index) = 0; // as after the allocation
+			}
+		#endif
 	}
+
+	#if TRACK_BEST_ASSIGNMENT
+		start_best_tracking();
+	#endif
 	
 	#if DEBUG_OUTPUT
 		std::cout << "cfg for formula with " << num_clauses << " clauses and " << bformula.num_vars() << " variables created" << std::endl;
@@ -517,6 +841,10 @@ INSTANCE_CLASS_::serial_instance(const cnf_formula_t &bf_in_cnf, prob_func_t &pr
 		std::cout << "ADDITIONAL_CHECKS = 1" << std::endl;
 	#endif
 
+	#if USE_SIMD_BREAK_EVAL && !USE_INTERLEAVED_VAR_STATE
+		simd = used_simd_level();
+	#endif
+
 	#if ALLOW_UNCLEAN_CLAUSES
 		#if DEBUG_OUTPUT
 			std::cout << "ALLOW_UNCLEAN_CLAUSES = 1" << std::endl;
@@ -533,7 +861,7 @@ INSTANCE_TEMPLATE_
 void INSTANCE_CLASS_::do_flip() {
 	// zufällig unerfüllte Klausel bestimmen
 	num_t random_ci = get_index_of_random_unsatisfied_clause();
-	const clause_t rclause = bformula.get_clause(random_ci);
+	const clause_view_t rclause = bformula.get_clause_view(random_ci);
 	
 	#if DEBUG_OUTPUT
 		std::cout << "\n\nrandom unsat clause no " << random_ci << " in flip " << get_num_flips() << " is " << rclause << std::endl;
@@ -541,7 +869,7 @@ void INSTANCE_CLASS_::do_flip() {
 		for (std::size_t i = 0; i < rclause.num_vars(); i++) {
 			num_t lit = rclause[i];
 			num_t var_index = abs(lit)-1;
-			const bool value = belegung[var_index];
+			const bool value = get_value(var_index);
 				std::cout << "\t literal " << lit << " with var_index " << var_index
 					<< " has value " << (value ? "1" : "0") << " and is " << (((0 > lit) ^ value) ? "sat" : "unsat") << std::endl;
 		}
@@ -556,37 +884,58 @@ void INSTANCE_CLASS_::do_flip() {
 	#endif
 	
 	// Funktion f(num_breaks) für jedes Literal bestimmen und aufsummieren
-	static thread_local std::vector<prec_t> f;
-	f.reserve(rclause.num_vars());
+	assert((0 == ADDITIONAL_CHECKS) || (rclause.num_vars() <= f.size()));
 	prec_t sum_f = 0;
 	// std::cout << "calculate sum_f:" <<  std::endl;
-	for (std::size_t i = 0; i < rclause.num_vars(); i++) {
-		num_t literal = rclause[i];
-		cnt_t num_breaks = get_num_breaks_by_flip(literal);
-		// std::cout << "\tnum_breaks: " << (int) num_breaks << std::endl;
-		prec_t cf = calc_f(num_breaks);
-		assert((0 == ADDITIONAL_CHECKS) || (0 < cf));
-		// std::cout << "\tcf: " << cf << std::endl;
-		sum_f += cf;
-		f[i] = sum_f;
+	if (!calc_sum_f_simd(rclause, f.data(), sum_f)) {
+		rclause.for_each_index([&](const std::size_t i) {
+			num_t literal = rclause[i];
+			cnt_t num_breaks = get_num_breaks_by_flip(literal);
+			// std::cout << "\tnum_breaks: " << (int) num_breaks << std::endl;
+			prec_t cf = calc_f(num_breaks);
+			assert((0 == ADDITIONAL_CHECKS) || (0 < cf));
+			// std::cout << "\tcf: " << cf << std::endl;
+			sum_f += cf;
+			f[i] = sum_f;
+			return true;
+		});
 	}
 
 	assert((0 == ADDITIONAL_CHECKS) || (0 < rclause.num_vars()));
 	// zufälliges Literal auswählen
 	prec_t r = get_random_value(sum_f); // must be in range [0, sum_f), important is != sum_f
 	num_t rlit = 0;
-	for (std::size_t i = 0; i < rclause.num_vars(); i++) {
-		if (r < f[i]) {
-			assert((0 == ADDITIONAL_CHECKS) || (0 == rlit));
-			rlit = rclause[i];
-			break;
-		}
+	if (!pick_literal_simd(rclause, f.data(), r, rlit)) {
+		rclause.for_each_index([&](const std::size_t i) {
+			if (r < f[i]) {
+				assert((0 == ADDITIONAL_CHECKS) || (0 == rlit));
+				rlit = rclause[i];
+				return false;
+			}
+			return true;
+		});
 	}
 	
 	assert((0 == ADDITIONAL_CHECKS) || (0 != rlit));
 	flip_literal(rlit);
 
 	num_flips_done++;
+
+	#if TRACK_BEST_ASSIGNMENT
+		update_best(abs(rlit) - 1);
+	#endif
+}
+
+
+INSTANCE_TEMPLATE_
+std::size_t INSTANCE_CLASS_::do_flips(const std::size_t n) {
+	// callers check their own termination conditions (max. flips, stop requests) only between batches
+	const std::size_t start = num_flips_done;
+	const std::size_t end = start + n;
+	while ((num_flips_done < end) && !unsat_clauses.empty()) {
+		do_flip();
+	}
+	return num_flips_done - start;
 }
 
 
@@ -596,19 +945,55 @@ bool INSTANCE_CLASS_::found_solution() const {
 }
 
 
+INSTANCE_TEMPLATE_
+void INSTANCE_CLASS_::reset(const belegung_t &new_config) {
+	assert((0 == ADDITIONAL_CHECKS) || ((std::size_t) new_config.size() == (std::size_t) bformula.num_vars()));
+
+	// element wise, so belegung keeps its memory
+	for (num_t var_index = 0; var_index < bformula.num_vars(); var_index++) {
+		belegung[var_index] = (bool) new_config[var_index];
+	}
+
+	initialize_state();
+}
+
+
+INSTANCE_TEMPLATE_
+void INSTANCE_CLASS_::perturb(const double fraction) {
+	assert((0 == ADDITIONAL_CHECKS) || ((0. <= fraction) && (fraction <= 1.)));
+
+	// variables are drawn with replacement, a variable drawn twice keeps its value
+	const uint64_t num_vars = bformula.num_vars();
+	const uint64_t num_perturbed = std::llround(fraction * num_vars);
+	const uint64_t range = (uint64_t) rgenerator.get_rand_max() + 1u;
+	for (uint64_t i = 0; i < num_perturbed; i++) {
+		const num_t var_index = (rgenerator.rand() * num_vars) / range;
+		// flip_literal expects the currently unsatisfied literal of the variable
+		flip_literal(get_value(var_index) ? -(var_index + 1) : (var_index + 1));
+	}
+
+	num_flips_done = 0;
+	pick_position = 0;
+
+	#if TRACK_BEST_ASSIGNMENT
+		start_best_tracking();
+	#endif
+}
+
+
 INSTANCE_TEMPLATE_
 bool INSTANCE_CLASS_::check_assignment() const {
 	for (num_t i = 0; i < bformula.num_clauses(); i++) {
-		if (!is_clause_satisfied(bformula.get_clause(i))) {
+		if (!is_clause_satisfied(bformula.get_clause_view(i))) {
 			assert((0 == ADDITIONAL_CHECKS) || (0 == get_num_sat_lit_in_clause(i)));
 			
 			#if DEBUG_OUTPUT
-				const clause_t uclause = bformula.get_clause(i);
+				const clause_view_t uclause = bformula.get_clause_view(i);
 				std::cout << "check_assignment: clause " << i << " is not satisfied (" << uclause << ")" << std::endl;
 				for (std::size_t i = 0; i < uclause.num_vars(); i++) {
 					num_t lit = uclause[i];
 					num_t var_index = abs(lit)-1;
-					const bool value = belegung[var_index];
+					const bool value = get_value(var_index);
 					std::cout << "literal " << lit << " has value " << (value ? "1" : "0")
 						<< " and is " << (((0 > lit) ^ value) ? "sat" : "unsat") << std::endl;
 				}
@@ -634,4 +1019,99 @@ std::size_t INSTANCE_CLASS_::get_num_flips() {
 }
 
 
+INSTANCE_TEMPLATE_
+const typename INSTANCE_CLASS_::configuration_type& INSTANCE_CLASS_::get_assignment() const {
+	#if USE_INTERLEAVED_VAR_STATE
+		for (num_t var_index = 0; var_index < bformula.num_vars(); var_index++) {
+			belegung[var_index] = variables[var_index].value;
+		}
+	#endif
+
+	return belegung;
+}
+
+
+
+#if TRACK_BEST_ASSIGNMENT
+
+	INSTANCE_TEMPLATE_
+	void INSTANCE_CLASS_::start_best_tracking() {
+		min_num_unsat = unsat_clauses.size();
+		min_num_unsat_flips = num_flips_done;
+		best_trail.clear();
+		best_copied = false;
+	}
+
+
+	INSTANCE_TEMPLATE_
+	inline void INSTANCE_CLASS_::update_best(const num_t flipped_var_index) {
+		if (unsat_clauses.size() < min_num_unsat) {
+			min_num_unsat = unsat_clauses.size();
+			min_num_unsat_flips = num_flips_done;
+			best_trail.clear();
+			best_copied = false;
+		} else if (!best_copied) {
+			best_trail.push_back(flipped_var_index);
+			if (best_trail.size() > (std::size_t) bformula.num_vars()) {
+				// undoing the trail would be more expensive than a copy, at most one copy per num_vars flips
+				copy_best();
+			}
+		}
+	}
+
+
+	INSTANCE_TEMPLATE_
+	void INSTANCE_CLASS_::copy_best() {
+		best_belegung = get_best_assignment();
+		best_trail.clear();
+		best_copied = true;
+	}
+
+
+	INSTANCE_TEMPLATE_
+	std::size_t INSTANCE_CLASS_::get_min_number_of_unsat_clauses() const {
+		return min_num_unsat;
+	}
+
+
+	INSTANCE_TEMPLATE_
+	std::size_t INSTANCE_CLASS_::get_min_number_of_unsat_clauses_flips() const {
+		return min_num_unsat_flips;
+	}
+
+
+	INSTANCE_TEMPLATE_
+	typename INSTANCE_CLASS_::belegung_t INSTANCE_CLASS_::get_best_assignment() const {
+		if (best_copied) {
+			return best_belegung;
+		}
+
+		belegung_t best = get_assignment();
+		for (const num_t var_index : best_trail) {
+			best[var_index] = !best[var_index];
+		}
+		return best;
+	}
+
+
+	INSTANCE_TEMPLATE_
+	void INSTANCE_CLASS_::restore_best() {
+		if (best_copied) {
+			reset(best_belegung);
+		} else {
+			// undo the flips since the best assignment, the last one first
+			for (auto it = best_trail.rbegin(); it != best_trail.rend(); it++) {
+				const num_t var_index = *it;
+				flip_literal(get_value(var_index) ? -(var_index + 1) : (var_index + 1));
+			}
+
+			num_flips_done = 0;
+			pick_position = 0;
+			start_best_tracking();
+		}
+	}
+
+#endif
+
+
 #endif
@@ -2,20 +2,47 @@
 #define PROB_FUNC_CACHED
 
 #include <vector>
+#include <memory>
+#include <algorithm>
+#include <atomic>
 #include <mutex>
 
+// the cache is filled completely in set_max_num_breaks_possible (called once per serial_instance)
+// a filled table is never modified again, a larger one is published with release semantics,
+// so calc_prob_function needs no locking (manythreads has no effect any more)
 template<typename num_t, typename prec_t, typename prob_func_implementation_t, bool multithreaded = false, bool manythreads = false>
 class prob_func_cached {
-	std::vector<prec_t> cache;
 	const prob_func_implementation_t pfi;
-	std::mutex mtx;
+
+	// all tables ever published, older tables are kept as other threads may still read them
+	std::vector<std::unique_ptr<prec_t[]>> tables;
+	std::atomic<const prec_t*> cache;
+	std::atomic<std::size_t> cache_size;
+	std::mutex mtx; // only used by writers
+
+	void grow(std::size_t size) {
+		const std::size_t old_size = cache_size.load(std::memory_order_relaxed);
+		if (size <= old_size) {
+			return; // another thread was faster
+		}
+
+		size = std::max(size, 2 * old_size);
+		std::unique_ptr<prec_t[]> table(new prec_t[size]);
+		for (std::size_t num_breaks = 0; num_breaks < size; num_breaks++) {
+			table[num_breaks] = pfi.calc_prob_function(num_breaks);
+		}
+
+		cache.store(table.get(), std::memory_order_release);
+		cache_size.store(size, std::memory_order_release);
+		tables.push_back(std::move(table));
+	}
 
 	public:
 		using prec_type = prec_t;
 		static constexpr bool is_prob_func_impl_t = true;
 
 		prob_func_cached(const prob_func_implementation_t &&prob_func_impl)
-			: cache(), pfi(std::move(prob_func_impl)), mtx()
+			: pfi(std::move(prob_func_impl)), tables(), cache(nullptr), cache_size(0), mtx()
 		{
 			// false == (manythreads && (false == multithreaded))
 			static_assert(!manythreads || multithreaded);
@@ -25,57 +52,29 @@ class prob_func_cached {
 
 		prob_func_cached(const prob_func_cached&) = delete;
 
-		prec_t calc_prob_function(num_t num_breaks) {
-			prec_t f = pfi.calc_prob_function(num_breaks);
+		inline prec_t calc_prob_function(num_t num_breaks) const {
+			// the calling thread has called set_max_num_breaks_possible before, so it sees a table
+			// which is at least as large as required (tables only grow)
+			const prec_t *table = cache.load(multithreaded ? std::memory_order_acquire : std::memory_order_relaxed);
 
 			assert((0 == ADDITIONAL_CHECKS) || (0 <= num_breaks));
-			assert((0 == ADDITIONAL_CHECKS) || ((std::size_t) num_breaks < cache.size()));
-
-			// read only access shouldn't require locking, but might be problematic?
-			prec_t v = cache[num_breaks];
-			if (0. < v) {
-				assert((0 == ADDITIONAL_CHECKS) || (f == v));
-				return v;
-			} else {
-				if (multithreaded) {
-					if (manythreads) {
-						// variant: dont wait until data can be written to cache,
-						// might have overall better performance if many threads are used
-						{
-							std::unique_lock<std::mutex> lock(mtx, std::defer_lock);
-							if (lock.try_lock()) {
-								cache[num_breaks] = f;
-							}
-						}
-						// if (mtx.try_lock()) {
-							// cache[num_breaks] = f;
-							// mtx.unlock();
-						// }
-					} else {
-						{ // mtx.lock();
-							std::lock_guard<std::mutex> lock(mtx);
-							cache[num_breaks] = f;
-						} // mtx.unlock();
-					}
-				} else {
-					cache[num_breaks] = f;
-				}
-			}
+			assert((0 == ADDITIONAL_CHECKS) || ((std::size_t) num_breaks < cache_size.load()));
+			assert((0 == ADDITIONAL_CHECKS) || (pfi.calc_prob_function(num_breaks) == table[num_breaks]));
 
-			return f;
+			return table[num_breaks];
 		}
 
 		void set_max_num_breaks_possible(num_t num_breaks) {
 			// std::cout << "max_num_breaks_possible: " << num_breaks << std::endl;
 			assert((0 == ADDITIONAL_CHECKS) || (0 <= num_breaks));
-			if (cache.size() <= (std::size_t) num_breaks) {
+			if (cache_size.load(std::memory_order_acquire) <= (std::size_t) num_breaks) {
 				if (multithreaded) {
 					{ // mtx.lock();
 						std::lock_guard<std::mutex> lock(mtx);
-						cache.resize(num_breaks + 1);
+						grow(num_breaks + 1);
 					} // mtx.unlock();
 				} else {
-					cache.resize(num_breaks + 1);
+					grow(num_breaks + 1);
 				}
 			}
 		}
@@ -0,0 +1,52 @@
+#ifndef PROB_FUNC_TABLE
+#define PROB_FUNC_TABLE
+
+#include "../../config.hpp"
+
+#include <cassert>
+#include <vector>
+#include <stdexcept>
+#include <string>
+
+// precomputed values of the probability function for every possible number of breaks
+// the table is built once per formula (before solver threads are started) and afterwards
+// only read, so it can be shared by all threads without any synchronization
+template<typename num_t, typename prec_t, typename prob_func_implementation_t>
+class prob_func_table {
+	std::vector<prec_t> table;
+
+	public:
+		using prec_type = prec_t;
+		static constexpr bool is_prob_func_impl_t = true;
+
+		prob_func_table(const prob_func_implementation_t &prob_func_impl, num_t max_num_breaks_possible)
+			: table()
+		{
+			assert((0 == ADDITIONAL_CHECKS) || (0 <= max_num_breaks_possible));
+			table.reserve(max_num_breaks_possible + 1);
+			for (num_t num_breaks = 0; num_breaks <= max_num_breaks_possible; num_breaks++) {
+				table.push_back(prob_func_impl.calc_prob_function(num_breaks));
+			}
+		}
+
+		prob_func_table(const prob_func_table&) = delete;
+
+		inline prec_t calc_prob_function(num_t num_breaks) const {
+			assert((0 == ADDITIONAL_CHECKS) || ((0 <= num_breaks) && ((std::size_t) num_breaks < table.size())));
+			return table[num_breaks];
+		}
+
+		// table[num_breaks], used by the vectorized evaluation in serial_instance::do_flip
+		inline const prec_t* data() const {
+			return table.data();
+		}
+
+		void set_max_num_breaks_possible(num_t num_breaks) const {
+			if (table.size() <= (std::size_t) num_breaks) {
+				throw std::out_of_range("prob_func_table: table is too small, it was built for at most "
+					+ std::to_string(table.size() - 1) + " breaks but " + std::to_string(num_breaks) + " are possible");
+			}
+		}
+};
+
+#endif
@@ -17,7 +17,7 @@ class random_generator {
 
 	private:
 		// srand() & rand is not guaranteed to be thread-safe!
-		const seed_t seed;
+		seed_t seed;
 	
 	public:
 		static constexpr bool is_random_generator_impl_t = true;
@@ -37,6 +37,12 @@ class random_generator {
 			return seed;
 		}
 
+		// restart the sequence, e.g. for a new try with the same serial_instance
+		void reseed(const seed_t new_seed) {
+			seed = new_seed;
+			srand(seed);
+		}
+
 		auto rand() {
 			return call_rand();
 		}
@@ -58,7 +64,7 @@ class lin_cong_random_generator {
 	public:
 		using seed_t = decltype(r());
 	private:
-		const seed_t seed;
+		seed_t seed;
 		std::minstd_rand engine;
 
 	public:
@@ -79,6 +85,12 @@ class lin_cong_random_generator {
 			return seed;
 		}
 
+		// restart the sequence, e.g. for a new try with the same serial_instance
+		void reseed(const seed_t new_seed) {
+			seed = new_seed;
+			engine.seed(seed);
+		}
+
 		auto rand() {
 			return engine() - engine.min();
 		}
@@ -0,0 +1,310 @@
+#ifndef SHARED_FORMULA_HPP
+#define SHARED_FORMULA_HPP
+
+// Formeln, die von allen Prozessen eines Knotens gemeinsam genutzt werden (Binärformat im Shared Memory)
+
+#include "../config.hpp"
+#include "dispatch.hpp"
+
+#include <string>
+
+
+// Macros used:
+// USE_FLAT_CLAUSE_STORAGE, USE_CONT_DATASTRUCT - required for the binary format, otherwise every process parses the formula
+
+
+// like load_cnf_formula, but all processes of a node use one image of the formula in the binary format
+// (see binary_formula.hpp) in a subdirectory of directory, e.g. /dev/shm/probsat-<uid> (mode 0700, only the processes
+// of the same user share the images): the first process parses the formula and writes the image,
+// all processes map it read only, so the pages are shared. The image is removed when the last process unmaps it
+// (its empty lock file stays), images of processes which were killed are removed by the next process.
+// An empty directory, a directory which can't be used or an image which can't be written falls back to load_cnf_formula
+template<typename F>
+void load_shared_cnf_formula(const std::string &filename, F &&f, const std::string &directory, const bool specialize_clauses = true);
+
+// name of the image of the file in the directory, changes with the modification time and size of the file
+std::string get_shared_formula_name(const std::string &filename);
+
+
+// *********************************************************************
+// Implementation:
+// *********************************************************************
+
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+inline std::string get_shared_formula_name(const std::string &filename) {
+	const std::filesystem::path path = std::filesystem::canonical(filename);
+	const int64_t mtime = std::filesystem::last_write_time(path).time_since_epoch().count();
+	const uintmax_t size = std::filesystem::file_size(path);
+
+	std::ostringstream oss;
+	oss << "probsat-" << std::hex << std::hash<std::string>()(path.string() + "|" + std::to_string(mtime) + "|" + std::to_string(size))
+		<< "-" << std::dec << size << ".bin";
+	return oss.str();
+}
+
+
+#if USE_FLAT_CLAUSE_STORAGE && USE_CONT_DATASTRUCT
+
+	// protocol: the lock file of an image is locked exclusively while the image is created or removed,
+	// every process holds a shared lock on the image itself while it's mapped,
+	// so the image can only be removed (by the last process) if nobody else has locked it
+
+	// directory/probsat-<uid>, created if it's missing, or an empty string if it can't be used:
+	// it has to be a directory (not a symlink) of the user which nobody else can access,
+	// so the predictable names of the images can't be taken or replaced by other users of e.g. /dev/shm
+	inline std::string get_private_shared_formula_directory(const std::string &directory) {
+		const std::string name = directory + "/probsat-" + std::to_string(geteuid());
+		if ((0 != mkdir(name.c_str(), 0700)) && (EEXIST != errno)) {
+			return "";
+		}
+
+		struct stat st;
+		if ((0 != lstat(name.c_str(), &st)) || !S_ISDIR(st.st_mode) || (geteuid() != st.st_uid) || (0 != (st.st_mode & 077))) {
+			return "";
+		}
+		return name;
+	}
+
+
+	// returns the file descriptor of the locked lock file or -1
+	inline int lock_shared_formula(const std::string &lock_name) {
+		const int fd = open(lock_name.c_str(), O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC, 0600);
+		if (0 > fd) {
+			return -1;
+		}
+
+		while (0 != flock(fd, LOCK_EX)) {
+			if (EINTR != errno) {
+				close(fd);
+				return -1;
+			}
+		}
+		return fd;
+	}
+
+
+	// wheter fd is still the file with this name (it may have been replaced or removed)
+	inline bool is_same_file(const int fd, const std::string &name) {
+		struct stat opened, current;
+		return (0 == fstat(fd, &opened)) && (0 == stat(name.c_str(), &current))
+			&& (opened.st_dev == current.st_dev) && (opened.st_ino == current.st_ino);
+	}
+
+
+	// removes the images and temporary images of processes which ended without releasing them (e.g. killed by a job
+	// timeout or MPI_Abort), they would stay in a RAM backed directory until the next reboot. An image nobody has
+	// a shared lock on is stale, unless its lock file is locked (the image is being created or removed)
+	inline void remove_stale_shared_formulas(const std::string &directory) {
+		std::vector<std::filesystem::path> candidates;
+		std::error_code error;
+		const std::filesystem::directory_iterator end;
+		for (std::filesystem::directory_iterator it(directory, error); !error && (it != end); it.increment(error)) {
+			const std::string name = it->path().filename().string();
+			const bool image = (4 < name.size()) && (0 == name.compare(name.size() - 4, 4, ".bin"));
+			const bool tmp = (4 < name.size()) && (0 == name.compare(name.size() - 4, 4, ".tmp"));
+			if ((0 == name.rfind("probsat-", 0)) && (image || tmp)) {
+				candidates.push_back(it->path());
+			}
+		}
+
+		for (const std::filesystem::path &path : candidates) {
+			// <image>.<pid>.tmp is written under the lock file of <image>
+			std::string image_name = path.string();
+			const bool tmp = (0 == path.extension().compare(".tmp"));
+			if (tmp) {
+				image_name = path.parent_path() / path.stem().stem();
+			}
+
+			const int lock_fd = open((image_name + ".lock").c_str(), O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC, 0600);
+			if (0 > lock_fd) {
+				continue;
+			}
+
+			if (0 == flock(lock_fd, LOCK_EX | LOCK_NB)) {
+				if (tmp) {
+					unlink(path.c_str());
+				} else {
+					const int image_fd = open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+					if (0 <= image_fd) {
+						if ((0 == flock(image_fd, LOCK_EX | LOCK_NB)) && is_same_file(image_fd, path.string())) {
+							unlink(path.c_str());
+						}
+						close(image_fd);
+					}
+				}
+			}
+			close(lock_fd); // releases the lock
+		}
+	}
+
+
+	// called when a process doesn't need the image anymore
+	inline void release_shared_formula(const int image_fd, const std::string &image_name, const std::string &lock_name) {
+		const int lock_fd = lock_shared_formula(lock_name);
+
+		// the conversion to an exclusive lock only succeeds if no other process has mapped the image
+		if ((0 <= lock_fd) && (0 == flock(image_fd, LOCK_EX | LOCK_NB)) && is_same_file(image_fd, image_name)) {
+			unlink(image_name.c_str());
+		}
+
+		close(image_fd);
+		if (0 <= lock_fd) {
+			close(lock_fd); // releases the lock
+		}
+	}
+
+
+	// the image with a shared lock or nullptr if there is no valid image
+	inline std::shared_ptr<const mapped_file> map_shared_formula(const std::string &image_name, const std::string &lock_name) {
+		const int image_fd = open(image_name.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+		if (0 > image_fd) {
+			return nullptr;
+		}
+
+		// only images written by the user
+		struct stat st;
+		if ((0 != fstat(image_fd, &st)) || !S_ISREG(st.st_mode) || (geteuid() != st.st_uid)) {
+			close(image_fd);
+			return nullptr;
+		}
+
+		if (0 != flock(image_fd, LOCK_SH)) {
+			close(image_fd);
+			return nullptr;
+		}
+
+		std::unique_ptr<const mapped_file> mapped;
+		try {
+			mapped = std::make_unique<const mapped_file>(image_name);
+			get_binary_formula_header(*mapped); // e.g. an image of an older version
+		} catch (...) {
+			close(image_fd);
+			return nullptr;
+		}
+
+		return std::shared_ptr<const mapped_file>(mapped.release(), [image_fd, image_name, lock_name](const mapped_file *m) {
+			delete m;
+			release_shared_formula(image_fd, image_name, lock_name);
+		});
+	}
+
+#endif
+
+
+#if USE_FLAT_CLAUSE_STORAGE && USE_CONT_DATASTRUCT
+
+	// calls f with the formula parsed for the image (specialized clauses), converted to generic clauses if required
+	template<class formula_t, typename F>
+	void call_with_parsed_formula(const std::shared_ptr<const formula_t> &cnf_sptr, F &&f, const bool specialize_clauses) {
+		if constexpr (0 < formula_t::clause_view_t::static_width) {
+			if (!specialize_clauses) {
+				using num_t = typename formula_t::num_type;
+				using generic_formula_t = cnf_formula<num_t, typename formula_t::sum_type, typename formula_t::cnt_type, generic_clause<num_t>>;
+				std::shared_ptr<const generic_formula_t> bformula = std::make_shared<const generic_formula_t>(std::move(*cnf_sptr->make_local_copy()));
+				f(bformula);
+				return;
+			}
+		}
+		f(cnf_sptr);
+	}
+
+#endif
+
+
+template<typename F>
+void load_shared_cnf_formula(const std::string &filename, F &&f, const std::string &directory, const bool specialize_clauses) {
+	#if USE_FLAT_CLAUSE_STORAGE && USE_CONT_DATASTRUCT
+		// binary formulas are mapped anyway
+		if (directory.empty() || is_binary_formula(filename)) {
+			load_cnf_formula(filename, f, specialize_clauses);
+			return;
+		}
+
+		const std::string private_directory = get_private_shared_formula_directory(directory);
+		if (private_directory.empty()) {
+			load_cnf_formula(filename, f, specialize_clauses);
+			return;
+		}
+
+		remove_stale_shared_formulas(private_directory);
+
+		const std::string image_name = private_directory + "/" + get_shared_formula_name(filename);
+		const std::string lock_name = image_name + ".lock";
+
+		int lock_fd = lock_shared_formula(lock_name);
+		if (0 > lock_fd) {
+			load_cnf_formula(filename, f, specialize_clauses);
+			return;
+		}
+
+		std::shared_ptr<const mapped_file> image;
+		std::string tmp_name;
+		bool used_parsed_formula = false;
+		try {
+			image = map_shared_formula(image_name, lock_name);
+
+			if (!image) {
+				// first process of the node, the image is written with the specialized clause type and renamed when it's complete
+				tmp_name = image_name + "." + std::to_string(getpid()) + ".tmp";
+				load_cnf_formula(filename, [&](const auto cnf_sptr) {
+					bool written = false;
+					try {
+						cnf_sptr->save_binary(tmp_name);
+						written = (0 == std::rename(tmp_name.c_str(), image_name.c_str()));
+					} catch (const std::exception &) {
+						// e.g. the directory is full
+					}
+
+					if (written) {
+						image = map_shared_formula(image_name, lock_name);
+					} else {
+						unlink(tmp_name.c_str());
+					}
+
+					if (!image) {
+						// the image can't be written or mapped, so this process uses the formula it has just parsed
+						close(lock_fd);
+						lock_fd = -1;
+						call_with_parsed_formula(cnf_sptr, f, specialize_clauses);
+						used_parsed_formula = true;
+					}
+				});
+			}
+		} catch (...) {
+			if (!tmp_name.empty()) {
+				unlink(tmp_name.c_str());
+			}
+			if (0 <= lock_fd) {
+				close(lock_fd);
+			}
+			throw;
+		}
+
+		if (used_parsed_formula) {
+			return;
+		}
+
+		close(lock_fd); // releases the lock, the image is protected by the shared lock on it
+
+		load_binary_cnf_formula(image, f, specialize_clauses);
+	#else
+		ignore(directory);
+		load_cnf_formula(filename, f, specialize_clauses);
+	#endif
+}
+
+#endif
@@ -0,0 +1,270 @@
+#ifndef SIMD_BREAK_EVAL_HPP
+#define SIMD_BREAK_EVAL_HPP
+
+// Vektorisierte Auswertung der Wahrscheinlichkeitsfunktion für die Literale einer Klausel (AVX2 / AVX-512)
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "../util/util.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+	#define SIMD_BREAK_EVAL_X86 1
+#else
+	#define SIMD_BREAK_EVAL_X86 0
+#endif
+
+
+// instruction sets with a kernel, ordered
+enum class simd_level {
+	scalar,
+	avx2,
+	avx512 // avx512f + avx512vl + avx512bw
+};
+
+// best level supported by the cpu (cpuid), detected once
+simd_level detect_simd_level();
+
+// level used by instances created afterwards, the detected one unless lowered (e.g. by benchmark --simd)
+simd_level& used_simd_level();
+
+const char* simd_level_name(const simd_level level);
+
+// kernels exist for 16 and 32 bit literals and break counts
+template<typename num_t, typename cnt_t>
+constexpr bool simd_break_eval_supported() {
+	return SIMD_BREAK_EVAL_X86
+		&& ((2 == sizeof(num_t)) || (4 == sizeof(num_t)))
+		&& ((2 == sizeof(cnt_t)) || (4 == sizeof(cnt_t)));
+}
+
+// prob_func_t provides its precomputed table by data()
+template<class prob_func_t, typename = void>
+struct has_prob_func_table : std::false_type {};
+
+template<class prob_func_t>
+struct has_prob_func_table<prob_func_t, std::void_t<decltype(std::declval<const prob_func_t&>().data())>> : std::true_type {};
+
+// p[i] = table[breaks[abs(literals[i]) - 1]] for i < n
+// 16 bit break counts are gathered as 32 bit values, so breaks must be readable one element past the last variable
+template<typename num_t, typename cnt_t>
+void gather_break_probabilities(const simd_level level, const num_t *literals, const std::size_t n,
+	const cnt_t *breaks, const double *table, double *p);
+
+// index of the first f[i] with r < f[i], n if there is none
+std::size_t find_first_greater(const simd_level level, const double *f, const std::size_t n, const double r);
+
+
+// *********************************************************************
+// Implementation:
+// *********************************************************************
+
+#if SIMD_BREAK_EVAL_X86
+	#include <immintrin.h>
+#endif
+
+
+inline simd_level detect_simd_level() {
+	#if SIMD_BREAK_EVAL_X86
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512bw")) {
+			return simd_level::avx512;
+		}
+		if (__builtin_cpu_supports("avx2")) {
+			return simd_level::avx2;
+		}
+	#endif
+	return simd_level::scalar;
+}
+
+
+inline simd_level& used_simd_level() {
+	static simd_level level = detect_simd_level();
+	return level;
+}
+
+
+inline const char* simd_level_name(const simd_level level) {
+	switch (level) {
+		case simd_level::avx2:
+			return "avx2";
+		case simd_level::avx512:
+			return "avx512";
+		default:
+			return "scalar";
+	}
+}
+
+
+template<typename num_t, typename cnt_t>
+inline void gather_break_probabilities_scalar(const num_t *literals, const std::size_t n,
+	const cnt_t *breaks, const double *table, double *p)
+{
+	for (std::size_t i = 0; i < n; i++) {
+		const num_t literal = literals[i];
+		p[i] = table[breaks[((literal < 0) ? -literal : literal) - 1]];
+	}
+}
+
+
+inline std::size_t find_first_greater_scalar(const double *f, const std::size_t n, const double r) {
+	std::size_t i = 0;
+	while ((i < n) && !(r < f[i])) {
+		i++;
+	}
+	return i;
+}
+
+
+#if SIMD_BREAK_EVAL_X86
+
+	// 4 lanes per step: literals and break counts as 32 bit integers, probabilities as doubles
+	template<typename num_t, typename cnt_t>
+	__attribute__((target("avx2")))
+	void gather_break_probabilities_avx2(const num_t *literals, const std::size_t n,
+		const cnt_t *breaks, const double *table, double *p)
+	{
+		const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+		const __m128i one = _mm_set1_epi32(1);
+
+		for (std::size_t i = 0; i < n; i += 4) {
+			const std::size_t m = ((n - i) < 4) ? (n - i) : 4;
+			const __m128i mask = _mm_cmpgt_epi32(_mm_set1_epi32((int) m), lanes);
+
+			__m128i lits;
+			if constexpr (4 == sizeof(num_t)) {
+				lits = _mm_maskload_epi32((const int*) (literals + i), mask);
+			} else {
+				// no masked 16 bit load in avx2, the clause may end at the end of the allocation
+				alignas(16) int32_t tmp[4] = {1, 1, 1, 1};
+				for (std::size_t j = 0; j < m; j++) {
+					tmp[j] = literals[i + j];
+				}
+				lits = _mm_load_si128((const __m128i*) tmp);
+			}
+			const __m128i var_index = _mm_sub_epi32(_mm_abs_epi32(lits), one);
+
+			__m128i num_breaks;
+			if constexpr (4 == sizeof(cnt_t)) {
+				num_breaks = _mm_mask_i32gather_epi32(_mm_setzero_si128(), (const int*) breaks, var_index, mask, 4);
+			} else {
+				num_breaks = _mm_mask_i32gather_epi32(_mm_setzero_si128(), (const int*) breaks, var_index, mask, 2);
+				num_breaks = _mm_and_si128(num_breaks, _mm_set1_epi32(0xFFFF));
+			}
+
+			const __m256i mask64 = _mm256_cvtepi32_epi64(mask);
+			const __m256d prob = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), table, num_breaks,
+				_mm256_castsi256_pd(mask64), 8);
+			_mm256_maskstore_pd(p + i, mask64, prob);
+		}
+	}
+
+
+	__attribute__((target("avx2")))
+	inline std::size_t find_first_greater_avx2(const double *f, const std::size_t n, const double r) {
+		const __m256d rv = _mm256_set1_pd(r);
+		const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+
+		for (std::size_t i = 0; i < n; i += 4) {
+			const std::size_t m = ((n - i) < 4) ? (n - i) : 4;
+			const __m256i mask64 = _mm256_cvtepi32_epi64(_mm_cmpgt_epi32(_mm_set1_epi32((int) m), lanes));
+			const __m256d fv = _mm256_maskload_pd(f + i, mask64);
+			const int greater = _mm256_movemask_pd(_mm256_cmp_pd(rv, fv, _CMP_LT_OQ)) & ((1 << m) - 1);
+			if (0 != greater) {
+				return i + __builtin_ctz(greater);
+			}
+		}
+		return n;
+	}
+
+
+	// 8 lanes per step, masked loads don't touch memory of inactive lanes
+	template<typename num_t, typename cnt_t>
+	__attribute__((target("avx512f,avx512vl,avx512bw")))
+	void gather_break_probabilities_avx512(const num_t *literals, const std::size_t n,
+		const cnt_t *breaks, const double *table, double *p)
+	{
+		const __m256i one = _mm256_set1_epi32(1);
+
+		for (std::size_t i = 0; i < n; i += 8) {
+			const std::size_t m = ((n - i) < 8) ? (n - i) : 8;
+			const __mmask8 mask = (__mmask8) ((1u << m) - 1);
+
+			__m256i lits;
+			if constexpr (4 == sizeof(num_t)) {
+				lits = _mm256_maskz_loadu_epi32(mask, literals + i);
+			} else {
+				lits = _mm256_cvtepi16_epi32(_mm_maskz_loadu_epi16(mask, literals + i));
+			}
+			const __m256i var_index = _mm256_sub_epi32(_mm256_abs_epi32(lits), one);
+
+			__m256i num_breaks;
+			if constexpr (4 == sizeof(cnt_t)) {
+				num_breaks = _mm256_mmask_i32gather_epi32(_mm256_setzero_si256(), mask, var_index, breaks, 4);
+			} else {
+				num_breaks = _mm256_mmask_i32gather_epi32(_mm256_setzero_si256(), mask, var_index, breaks, 2);
+				num_breaks = _mm256_and_si256(num_breaks, _mm256_set1_epi32(0xFFFF));
+			}
+
+			const __m512d prob = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), mask, num_breaks, table, 8);
+			_mm512_mask_storeu_pd(p + i, mask, prob);
+		}
+	}
+
+
+	__attribute__((target("avx512f,avx512vl,avx512bw")))
+	inline std::size_t find_first_greater_avx512(const double *f, const std::size_t n, const double r) {
+		const __m512d rv = _mm512_set1_pd(r);
+
+		for (std::size_t i = 0; i < n; i += 8) {
+			const std::size_t m = ((n - i) < 8) ? (n - i) : 8;
+			const __mmask8 mask = (__mmask8) ((1u << m) - 1);
+			const __m512d fv = _mm512_maskz_loadu_pd(mask, f + i);
+			const unsigned greater = _mm512_mask_cmp_pd_mask(mask, rv, fv, _CMP_LT_OQ);
+			if (0 != greater) {
+				return i + __builtin_ctz(greater);
+			}
+		}
+		return n;
+	}
+
+#endif
+
+
+template<typename num_t, typename cnt_t>
+inline void gather_break_probabilities(const simd_level level, const num_t *literals, const std::size_t n,
+	const cnt_t *breaks, const double *table, double *p)
+{
+	#if SIMD_BREAK_EVAL_X86
+		if constexpr (simd_break_eval_supported<num_t, cnt_t>()) {
+			if (simd_level::avx512 == level) {
+				gather_break_probabilities_avx512(literals, n, breaks, table, p);
+				return;
+			} else if (simd_level::avx2 == level) {
+				gather_break_probabilities_avx2(literals, n, breaks, table, p);
+				return;
+			}
+		}
+	#endif
+
+	ignore(level);
+	gather_break_probabilities_scalar(literals, n, breaks, table, p);
+}
+
+
+inline std::size_t find_first_greater(const simd_level level, const double *f, const std::size_t n, const double r) {
+	#if SIMD_BREAK_EVAL_X86
+		if (simd_level::avx512 == level) {
+			return find_first_greater_avx512(f, n, r);
+		} else if (simd_level::avx2 == level) {
+			return find_first_greater_avx2(f, n, r);
+		}
+	#endif
+
+	ignore(level);
+	return find_first_greater_scalar(f, n, r);
+}
+
+#endif
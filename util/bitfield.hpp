@@ -3,172 +3,201 @@
 
 // Implementierung eines Bitvektors um Belegungen kompakt repräsentieren zu können
 
+#include <algorithm>
 #include <cstdint>
-// #include <cstddef>
+#include <cstddef>
 #include <cassert>
 #include <type_traits>
 #include <ostream>
+#include <vector>
 
 template<typename length_t>
 class bitfield {
+	public:
+		using word_t = uint64_t;
+		static constexpr std::size_t bits_per_word = 64;
+
 	private:
-		const length_t length; // number of bits
+		length_t length; // number of bits
+		std::vector<word_t> array; // data, unused bits of the last word are always zero
 
-		// helper values to allow returning references to memory
-		length_t last_mod_index;
-		bool last_mod_value;
 
-		uint8_t *array; // data
+		// helper functions
+		static inline std::size_t to_wordlength(const length_t l) {
+			return (((std::size_t) l) + bits_per_word - 1) / bits_per_word;
+		}
 
+		static inline word_t mask(const length_t index) {
+			return ((word_t) 1) << (((std::size_t) index) % bits_per_word);
+		}
 
-		// helper functions
-		static inline length_t to_bytelength(const length_t l) {
-			return (l+7) >> 3;
+		inline word_t& word(const length_t index) {
+			return array[((std::size_t) index) / bits_per_word];
+		}
+
+		inline const word_t& word(const length_t index) const {
+			return array[((std::size_t) index) / bits_per_word];
 		}
 
+	public:
+		// proxy object returned by the non const access operator (like std::vector<bool>::reference)
+		class reference {
+			private:
+				word_t &w;
+				const word_t m;
+
+			public:
+				reference(word_t &word_, const word_t mask_) : w(word_), m(mask_) {}
+
+				inline operator bool() const {
+					return 0 != (w & m);
+				}
+
+				inline reference& operator=(const bool value) {
+					if (value) {
+						w |= m;
+					} else {
+						w &= ~m;
+					}
+					return *this;
+				}
+
+				inline reference& operator=(const reference &other) {
+					return *this = (bool) other;
+				}
+
+				inline void flip() {
+					w ^= m;
+				}
+		};
+
+		// constructors
+		bitfield() : length(0), array() {}
+
+		bitfield(length_t n) : length(n), array(to_wordlength(n), 0) {}
+
+		// copy & swap idiom
+		friend void swap(bitfield &a, bitfield &b) noexcept {
+			std::swap(a.length, b.length);
+			std::swap(a.array, b.array);
+		}
+
+		bitfield(const bitfield &other) = default;
+
+		bitfield(bitfield &&other) : bitfield() {
+			swap(*this, other);
+		}
+
+		bitfield& operator=(bitfield other) {
+			swap(*this, other);
+			return *this;
+		}
+
+		// single bit access
 		inline bool get(const length_t index) const {
 			#if DEBUG_ASSERTIONS
 			assert(index < length);
 			#endif
-			return 1 & (array[index >> 3] >> (index & 0b111));
+			return 0 != (word(index) & mask(index));
 		}
 
 		inline void set(const length_t index, const bool value) {
 			#if DEBUG_ASSERTIONS
 			assert(index < length);
 			#endif
+			(*this)[index] = value;
+		}
 
-			const uint8_t mask = 1 << (index & 0b111);
-			if (value) {
-				array[index >> 3] |= mask;
-			} else {
-				array[index >> 3] &= ~mask;
-			}
+		inline void flip(const length_t index) {
+			#if DEBUG_ASSERTIONS
+			assert(index < length);
+			#endif
+			word(index) ^= mask(index);
 		}
 
-		inline void update() {
-			if (last_mod_index < length) {
-				// std::cout << "a["<<(int)last_mod_index<<"] = " << (int)last_mod_value << std::endl;
-				set(last_mod_index, last_mod_value);
-				last_mod_index = length;
-			}
+		inline reference operator[](const length_t index) {
+			#if DEBUG_ASSERTIONS
+			assert(index < length);
+			#endif
+			return reference(word(index), mask(index));
 		}
 
-	public:
-		// constructors
-		bitfield() : length(0), last_mod_index(length), last_mod_value(false), array(nullptr) {}
-		
-		bitfield(length_t n) :
-			length(n), last_mod_index(length), last_mod_value(false),
-			array(length > 0 ? new uint8_t[to_bytelength(length)] : nullptr) {}
-
-		// copy constructor
-		bitfield(const bitfield &other) :
-			length(other.length),
-			last_mod_index(other.last_mod_index),
-			last_mod_value(other.last_mod_value),
-			array(length > 0 ? new uint8_t[to_bytelength(length)] : nullptr)
-		{
-			for (length_t i = 0; i < to_bytelength(length); i++) {
-				array[i] = other.array[i];
-			}
+		inline bool operator[](const length_t index) const {
+			return get(index);
 		}
-		
-		// deconstructor
-		~bitfield() {
-			if (nullptr != array) {
-				#if DEBUG_ASSERTIONS
-					assert(0 < length);
-				#endif
-				delete[] array;
-				array = nullptr;
-			} else {
-				#if DEBUG_ASSERTIONS
-					assert(0 == length);
-				#endif
+
+		length_t size() const {
+			return length;
+		}
+
+		// bulk access
+		std::size_t num_words() const {
+			return array.size();
+		}
+
+		const word_t* words() const {
+			return array.data();
+		}
+
+		// copies n words starting at word offset, e.g. to reassemble a transferred assignment
+		void set_words(const std::size_t offset, const word_t *w, const std::size_t n) {
+			assert(offset + n <= array.size());
+			std::copy(w, w + n, array.begin() + offset);
+
+			// keep the unused bits of the last word zero
+			if ((0 < n) && (offset + n == array.size()) && (0 != ((std::size_t) length) % bits_per_word)) {
+				array.back() &= mask(length) - 1;
 			}
 		}
 
-		// copy & swap idiom
-        friend void swap(bitfield &a, bitfield &b)
-			noexcept(std::is_nothrow_swappable_v<length_t>
-				&&   std::is_nothrow_swappable_v<bool>
-				&&   std::is_nothrow_swappable_v<uint8_t*>)
-		{
-			#if DEBUG_ASSERTIONS
-			assert(a.length == b.length);
-			#endif
-			// or remove const from length
-            // std::swap(a.length, b.length);
-            std::swap(a.last_mod_index, b.last_mod_index);
-            std::swap(a.last_mod_value, b.last_mod_value);
-            std::swap(a.array, b.array);
-        }
-
-        bitfield(bitfield &&other) : bitfield() {
-            swap(*this, other);
-        }
-
-        bitfield& operator=(bitfield other) {
-            swap(*this, other);
-            return *this;
-        }
-
-		// access operators
-		inline bool& operator[](const length_t index) {
-			update();
+		// FNV-1a over the words, equal assignments have equal hashes
+		uint64_t hash() const {
+			uint64_t h = 14695981039346656037ull;
+			for (const word_t w : array) {
+				h ^= w;
+				h *= 1099511628211ull;
+			}
+			return h;
+		}
 
+		// number of variables with different values
+		std::size_t hamming_distance(const bitfield &other) const {
 			#if DEBUG_ASSERTIONS
-			assert(index < length);
+			assert(length == other.length);
 			#endif
+			std::size_t distance = 0;
+			for (std::size_t i = 0; i < array.size(); i++) {
+				distance += __builtin_popcountll(array[i] ^ other.array[i]);
+			}
+			return distance;
+		}
 
-			last_mod_index = index;
-			last_mod_value = get(index);
-			return last_mod_value;
+		bool operator==(const bitfield &other) const {
+			return (length == other.length) && (array == other.array);
 		}
-		
-		inline bool operator[](const length_t index) const {
-			if (index == last_mod_index) {
-				return last_mod_value;
-			}
 
-			// TODO: comment might be problematic
-			// update();
-			return get(index);
+		bool operator!=(const bitfield &other) const {
+			return !(*this == other);
 		}
-		
-		// output
-		std::ostream& print(std::ostream& os, const char *separator = " ") {
-			update();
-			
-			const length_t bl = to_bytelength(length);
 
+		// output
+		std::ostream& print(std::ostream& os, const char *separator = " ") const {
 			auto sep = "";
-			for (length_t i = 0; i < bl-1; i++) {
-				os << sep;
-				
-				uint8_t d = array[i];
-				for (uint8_t j = 0; j < 8; j++) {
-					os << ((d & 1) ? "1" : "0");
-					d >>= 1;
-				}
-				
-				sep = separator;
-			}
-			
-			if (0 < bl) {
-				os << sep;
-				for (length_t i = (bl-1)*8; i < length; i++) {
-					os << (get(i) ? "1" : "0");
+			for (length_t i = 0; i < length; i++) {
+				if ((0 < i) && (0 == i % 8)) {
+					sep = separator;
 				}
+
+				os << sep << (get(i) ? "1" : "0");
+				sep = "";
 			}
-			
+
 			return os;
-        }
+		}
 };
 
 template<typename length_t>
-std::ostream& operator<<(std::ostream& os, bitfield<length_t> bf) {
+std::ostream& operator<<(std::ostream& os, const bitfield<length_t> &bf) {
 	return bf.print(os);
 }
 
@@ -0,0 +1,438 @@
+#ifndef DECOMPRESSING_STREAM_HPP
+#define DECOMPRESSING_STREAM_HPP
+
+// Einlesen komprimierter Dateien (gzip, xz, zstd) als Stream, dekomprimiert wird von einem eigenen Thread
+
+#include "../config.hpp"
+#include "util.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <istream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// Macros used:
+// USE_ZLIB, USE_LZMA, USE_ZSTD - wheter the library for gzip, xz or zstd is available (see config.hpp)
+
+
+enum class compression {
+	none,
+	gzip,
+	xz,
+	zstd
+};
+
+// checks the magic bytes at the beginning of the file
+compression detect_compression(const std::string &filename);
+
+const char* get_compression_name(const compression type);
+
+
+// the decompressed data of the file, while the reader consumes a block the next blocks are decompressed
+// by another thread, errors of the decompression (e.g. truncated files) are rethrown by the reader
+class decompressing_streambuf : public std::streambuf {
+	private:
+		static constexpr std::size_t block_size = 1 << 20; // decompressed bytes per block
+		static constexpr std::size_t max_blocks = 4; // decompressed blocks which haven't been read yet
+		static constexpr std::size_t input_size = 1 << 18; // compressed bytes per read
+
+		std::mutex queue_mutex;
+		std::condition_variable queue_changed;
+		std::deque<std::vector<char>> filled; // decompressed blocks, oldest first
+		std::vector<std::vector<char>> spare; // read blocks for reuse
+		bool finished = false; // no more blocks will be filled
+		bool stopped = false; // the reader is gone
+		std::exception_ptr error;
+
+		std::vector<char> current; // block of the reader
+
+		// only used by the decompression thread
+		std::vector<char> output; // block which is filled
+		std::size_t output_used = 0;
+		std::thread decompressor;
+
+		void decompress(const std::string filename, const compression type);
+		// the decoders write to output_next() and call output_advance(), which returns false if the reader is gone
+		char* output_next();
+		std::size_t output_available() const;
+		bool output_advance(const std::size_t n);
+		bool output_flush();
+
+		void decompress_gzip(std::istream &is);
+		void decompress_xz(std::istream &is);
+		void decompress_zstd(std::istream &is);
+
+	protected:
+		int_type underflow() override;
+
+	public:
+		decompressing_streambuf(const std::string &filename, const compression type);
+		~decompressing_streambuf();
+
+		decompressing_streambuf(const decompressing_streambuf &other) = delete;
+		decompressing_streambuf& operator=(const decompressing_streambuf &other) = delete;
+};
+
+
+// std::istream with a decompressing_streambuf, errors of the decompression are thrown (badbit)
+class decompressing_istream : public std::istream {
+	private:
+		decompressing_streambuf buffer;
+
+	public:
+		decompressing_istream(const std::string &filename, const compression type) :
+			std::istream(nullptr), buffer(filename, type)
+		{
+			rdbuf(&buffer);
+			exceptions(std::ios::badbit);
+		}
+};
+
+
+// *********************************************************************
+// Implementation:
+// *********************************************************************
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+#if USE_ZLIB
+#include <zlib.h>
+#endif
+
+#if USE_LZMA
+#include <lzma.h>
+#endif
+
+#if USE_ZSTD
+#include <zstd.h>
+#endif
+
+
+inline compression detect_compression(const std::string &filename) {
+	static const uint8_t gzip_magic[] = {0x1f, 0x8b};
+	static const uint8_t xz_magic[] = {0xfd, '7', 'z', 'X', 'Z', 0x00};
+	static const uint8_t zstd_magic[] = {0x28, 0xb5, 0x2f, 0xfd};
+
+	uint8_t magic[8] = {};
+	std::ifstream filehandle(filename, std::ios::binary);
+	filehandle.read((char*) magic, sizeof(magic));
+	const std::size_t n = filehandle.gcount();
+
+	if ((sizeof(gzip_magic) <= n) && (0 == std::memcmp(magic, gzip_magic, sizeof(gzip_magic)))) {
+		return compression::gzip;
+	}
+	if ((sizeof(xz_magic) <= n) && (0 == std::memcmp(magic, xz_magic, sizeof(xz_magic)))) {
+		return compression::xz;
+	}
+	if ((sizeof(zstd_magic) <= n) && (0 == std::memcmp(magic, zstd_magic, sizeof(zstd_magic)))) {
+		return compression::zstd;
+	}
+	return compression::none;
+}
+
+
+inline const char* get_compression_name(const compression type) {
+	switch (type) {
+		case compression::gzip:
+			return "gzip";
+		case compression::xz:
+			return "xz";
+		case compression::zstd:
+			return "zstd";
+		default:
+			return "none";
+	}
+}
+
+
+inline decompressing_streambuf::decompressing_streambuf(const std::string &filename, const compression type) {
+	const bool available = ((compression::gzip == type) && USE_ZLIB)
+		|| ((compression::xz == type) && USE_LZMA)
+		|| ((compression::zstd == type) && USE_ZSTD);
+	if (!available) {
+		throw std::runtime_error("'" + filename + "' is " + get_compression_name(type)
+			+ " compressed, but the program was built without " + get_compression_name(type) + " support");
+	}
+
+	setg(nullptr, nullptr, nullptr);
+	decompressor = std::thread(&decompressing_streambuf::decompress, this, filename, type);
+}
+
+
+inline decompressing_streambuf::~decompressing_streambuf() {
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		stopped = true;
+	}
+	queue_changed.notify_all();
+	decompressor.join();
+}
+
+
+inline decompressing_streambuf::int_type decompressing_streambuf::underflow() {
+	std::unique_lock<std::mutex> lock(queue_mutex);
+
+	if (!current.empty()) {
+		spare.push_back(std::move(current));
+		current = std::vector<char>();
+	}
+
+	queue_changed.wait(lock, [this]() { return !filled.empty() || finished; });
+
+	if (filled.empty()) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+		return traits_type::eof();
+	}
+
+	current = std::move(filled.front());
+	filled.pop_front();
+	lock.unlock();
+	queue_changed.notify_all();
+
+	setg(current.data(), current.data(), current.data() + current.size());
+	return traits_type::to_int_type(current[0]);
+}
+
+
+inline void decompressing_streambuf::decompress(const std::string filename, const compression type) {
+	try {
+		std::ifstream filehandle(filename, std::ios::binary);
+		if (!filehandle) {
+			throw std::runtime_error("can't open '" + filename + "'");
+		}
+
+		output.resize(block_size);
+
+		switch (type) {
+			case compression::gzip:
+				decompress_gzip(filehandle);
+				break;
+			case compression::xz:
+				decompress_xz(filehandle);
+				break;
+			case compression::zstd:
+				decompress_zstd(filehandle);
+				break;
+			default:
+				throw std::runtime_error("'" + filename + "' isn't compressed");
+		}
+
+		output_flush();
+	} catch (...) {
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		error = std::current_exception();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		finished = true;
+	}
+	queue_changed.notify_all();
+}
+
+
+inline char* decompressing_streambuf::output_next() {
+	return output.data() + output_used;
+}
+
+
+inline std::size_t decompressing_streambuf::output_available() const {
+	return output.size() - output_used;
+}
+
+
+inline bool decompressing_streambuf::output_advance(const std::size_t n) {
+	output_used += n;
+	return (output_used < output.size()) || output_flush();
+}
+
+
+// hands the filled part of the block to the reader, waits while max_blocks are unread
+inline bool decompressing_streambuf::output_flush() {
+	std::unique_lock<std::mutex> lock(queue_mutex);
+	queue_changed.wait(lock, [this]() { return (filled.size() < max_blocks) || stopped; });
+	if (stopped) {
+		return false;
+	}
+
+	if (0 < output_used) {
+		output.resize(output_used);
+		filled.push_back(std::move(output));
+
+		if (spare.empty()) {
+			output = std::vector<char>(block_size);
+		} else {
+			output = std::move(spare.back());
+			spare.pop_back();
+			output.resize(block_size);
+		}
+		output_used = 0;
+	}
+
+	lock.unlock();
+	queue_changed.notify_all();
+	return true;
+}
+
+
+inline void decompressing_streambuf::decompress_gzip(std::istream &is) {
+	#if USE_ZLIB
+		z_stream stream = {};
+		// 15 + 32: maximal window, gzip or zlib header
+		if (Z_OK != inflateInit2(&stream, 15 + 32)) {
+			throw std::runtime_error("gzip: can't initialize the decompression");
+		}
+		std::unique_ptr<z_stream, int(*)(z_stream*)> stream_guard(&stream, &inflateEnd);
+
+		std::vector<char> input(input_size);
+		bool end_of_input = false;
+		bool member_complete = false;
+
+		while (true) {
+			if ((0 == stream.avail_in) && !end_of_input) {
+				is.read(input.data(), input.size());
+				stream.next_in = (Bytef*) input.data();
+				stream.avail_in = is.gcount();
+				end_of_input = (0 == stream.avail_in);
+			}
+
+			// concatenated files (e.g. from parallel gzip) consist of several members
+			if (member_complete) {
+				if (0 == stream.avail_in) {
+					return;
+				}
+				inflateReset(&stream);
+				member_complete = false;
+			}
+
+			stream.next_out = (Bytef*) output_next();
+			stream.avail_out = output_available();
+			const int result = inflate(&stream, Z_NO_FLUSH);
+
+			if ((Z_BUF_ERROR == result) && end_of_input) {
+				throw std::runtime_error("gzip: unexpected end of the compressed data");
+			}
+			if ((Z_OK != result) && (Z_STREAM_END != result) && (Z_BUF_ERROR != result)) {
+				throw std::runtime_error(std::string("gzip: invalid data (") + ((nullptr != stream.msg) ? stream.msg : "unknown error") + ")");
+			}
+			member_complete = (Z_STREAM_END == result);
+
+			if (!output_advance(output_available() - stream.avail_out)) {
+				return;
+			}
+		}
+	#else
+		ignore(is);
+	#endif
+}
+
+
+inline void decompressing_streambuf::decompress_xz(std::istream &is) {
+	#if USE_LZMA
+		lzma_stream stream = LZMA_STREAM_INIT;
+		if (LZMA_OK != lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED)) {
+			throw std::runtime_error("xz: can't initialize the decompression");
+		}
+		std::unique_ptr<lzma_stream, void(*)(lzma_stream*)> stream_guard(&stream, &lzma_end);
+
+		std::vector<char> input(input_size);
+		lzma_action action = LZMA_RUN;
+
+		while (true) {
+			if ((0 == stream.avail_in) && (LZMA_RUN == action)) {
+				is.read(input.data(), input.size());
+				stream.next_in = (const uint8_t*) input.data();
+				stream.avail_in = is.gcount();
+				if (0 == stream.avail_in) {
+					action = LZMA_FINISH;
+				}
+			}
+
+			stream.next_out = (uint8_t*) output_next();
+			stream.avail_out = output_available();
+			const lzma_ret result = lzma_code(&stream, action);
+
+			if (!output_advance(output_available() - stream.avail_out)) {
+				return;
+			}
+
+			if (LZMA_STREAM_END == result) {
+				return;
+			}
+			if (LZMA_OK != result) {
+				throw std::runtime_error((LZMA_BUF_ERROR == result) ?
+					"xz: unexpected end of the compressed data" : "xz: invalid data");
+			}
+		}
+	#else
+		ignore(is);
+	#endif
+}
+
+
+inline void decompressing_streambuf::decompress_zstd(std::istream &is) {
+	#if USE_ZSTD
+		std::unique_ptr<ZSTD_DStream, std::size_t(*)(ZSTD_DStream*)> stream(ZSTD_createDStream(), &ZSTD_freeDStream);
+		if (!stream) {
+			throw std::runtime_error("zstd: can't initialize the decompression");
+		}
+
+		std::vector<char> input(input_size);
+		std::size_t remaining = 0; // 0 after a complete frame
+
+		while (true) {
+			is.read(input.data(), input.size());
+			ZSTD_inBuffer in = {input.data(), (std::size_t) is.gcount(), 0};
+			if (0 == in.size) {
+				break;
+			}
+
+			// frames may be concatenated, the decompression continues with the next one
+			while (in.pos < in.size) {
+				ZSTD_outBuffer out = {output_next(), output_available(), 0};
+				remaining = ZSTD_decompressStream(stream.get(), &out, &in);
+				if (ZSTD_isError(remaining)) {
+					throw std::runtime_error(std::string("zstd: invalid data (") + ZSTD_getErrorName(remaining) + ")");
+				}
+
+				if (!output_advance(out.pos)) {
+					return;
+				}
+			}
+		}
+
+		// the decoder may still hold decompressed data of the last frame
+		while (0 < remaining) {
+			ZSTD_inBuffer in = {nullptr, 0, 0};
+			ZSTD_outBuffer out = {output_next(), output_available(), 0};
+			remaining = ZSTD_decompressStream(stream.get(), &out, &in);
+			if (ZSTD_isError(remaining)) {
+				throw std::runtime_error(std::string("zstd: invalid data (") + ZSTD_getErrorName(remaining) + ")");
+			}
+			if (0 == out.pos) {
+				throw std::runtime_error("zstd: unexpected end of the compressed data");
+			}
+			if (!output_advance(out.pos)) {
+				return;
+			}
+		}
+	#else
+		ignore(is);
+	#endif
+}
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef FILE_CACHE_HPP
+#define FILE_CACHE_HPP
+
+// LRU Cache für aus Dateien geladene Objekte (z.B. eingelesene Formeln)
+
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <string>
+#include <utility>
+
+
+// a file is identified by its path, modification time and size, so a changed file is loaded again,
+// the least recently used entries are dropped as soon as the sizes of all entries exceed the budget
+template<class value_t>
+class file_cache {
+	private:
+		struct file_id {
+			std::string path;
+			int64_t mtime = 0;
+			uintmax_t size = 0;
+
+			bool operator==(const file_id &other) const {
+				return (mtime == other.mtime) && (size == other.size) && (path == other.path);
+			}
+		};
+
+		struct entry {
+			file_id id;
+			value_t value;
+			std::size_t bytes;
+		};
+
+		std::list<entry> entries; // most recently used first
+		std::size_t budget; // bytes
+		std::size_t bytes_used = 0;
+		std::size_t num_hits = 0;
+		std::size_t num_misses = 0;
+		std::mutex cache_mutex;
+
+		static file_id identify(const std::string &filename);
+		void evict();
+
+	public:
+		file_cache(const std::size_t budget_bytes) : budget(budget_bytes) {}
+
+		file_cache(const file_cache &other) = delete;
+
+		// returns the cached value of the file or calls load(filename), which returns the value and its size in bytes,
+		// a value larger than the budget is returned but not cached (so a budget of 0 disables the cache)
+		template<typename F>
+		value_t get(const std::string &filename, F &&load);
+
+		void set_budget(const std::size_t budget_bytes);
+
+		std::size_t get_bytes_used() const {
+			return bytes_used;
+		}
+
+		std::size_t get_num_hits() const {
+			return num_hits;
+		}
+
+		std::size_t get_num_misses() const {
+			return num_misses;
+		}
+};
+
+
+// *********************************************************************
+// Implementation:
+// *********************************************************************
+
+template<class value_t>
+typename file_cache<value_t>::file_id file_cache<value_t>::identify(const std::string &filename) {
+	file_id id;
+	id.path = filename;
+
+	// a file that can't be accessed gets no cache entry, load() reports the error
+	std::error_code ec;
+	const auto mtime = std::filesystem::last_write_time(filename, ec);
+	if (!ec) {
+		id.mtime = std::chrono::duration_cast<std::chrono::nanoseconds>(mtime.time_since_epoch()).count();
+		id.size = std::filesystem::file_size(filename, ec);
+	}
+	if (ec) {
+		id.path.clear();
+	}
+
+	return id;
+}
+
+
+template<class value_t>
+void file_cache<value_t>::evict() {
+	while ((bytes_used > budget) && !entries.empty()) {
+		bytes_used -= entries.back().bytes;
+		entries.pop_back();
+	}
+}
+
+
+template<class value_t>
+template<typename F>
+value_t file_cache<value_t>::get(const std::string &filename, F &&load) {
+	const file_id id = identify(filename);
+
+	{ // cache_mutex.lock();
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		for (auto it = entries.begin(); it != entries.end(); it++) {
+			if (it->id == id) {
+				entries.splice(entries.begin(), entries, it);
+				num_hits++;
+				return entries.front().value;
+			}
+		}
+		num_misses++;
+	} // cache_mutex.unlock();
+
+	// loaded without the lock, two threads may load the same file at once
+	std::pair<value_t, std::size_t> loaded = load(filename);
+
+	if ((!id.path.empty()) && (loaded.second <= budget)) {
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		entries.push_front({id, loaded.first, loaded.second});
+		bytes_used += loaded.second;
+		evict();
+	}
+
+	return loaded.first;
+}
+
+
+template<class value_t>
+void file_cache<value_t>::set_budget(const std::size_t budget_bytes) {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	budget = budget_bytes;
+	evict();
+}
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef MAPPABLE_VECTOR_HPP
+#define MAPPABLE_VECTOR_HPP
+
+// Vektor dessen Inhalt auch ein (nur lesbarer) Bereich einer eingeblendeten Datei sein kann
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// behaves like a std::vector, but map() replaces the content by memory owned by someone else (e.g. a mapped_file),
+// which is kept alive by a shared_ptr and isn't copied. Modifications copy mapped content first (copy on write),
+// only writing through data(), [] or the iterators of mapped content is forbidden (the pages are read only)
+template<typename T>
+class mappable_vector {
+	private:
+		std::vector<T> owned;
+		std::shared_ptr<const void> mapping; // keeps the mapped memory alive, empty if the content is owned
+		T *ptr = nullptr; // owned.data() or the mapped memory
+		std::size_t count = 0;
+
+		inline void sync() {
+			ptr = owned.data();
+			count = owned.size();
+		}
+
+		inline void own() {
+			if (mapping) {
+				owned.assign(ptr, ptr + count);
+				mapping.reset();
+			}
+		}
+
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using iterator = T*;
+		using const_iterator = const T*;
+
+		// constructors
+		mappable_vector() {}
+
+		mappable_vector(std::initializer_list<T> init) : owned(init) {
+			sync();
+		}
+
+		mappable_vector(const mappable_vector &other) : owned(other.owned), mapping(other.mapping) {
+			if (mapping) {
+				ptr = other.ptr;
+				count = other.count;
+			} else {
+				sync();
+			}
+		}
+
+		// the buffer of a moved std::vector stays valid, so ptr stays valid as well
+		mappable_vector(mappable_vector &&other) noexcept : mappable_vector() {
+			swap(*this, other);
+		}
+
+		mappable_vector& operator=(mappable_vector other) {
+			swap(*this, other);
+			return *this;
+		}
+
+		friend void swap(mappable_vector &a, mappable_vector &b) noexcept {
+			std::swap(a.owned, b.owned);
+			std::swap(a.mapping, b.mapping);
+			std::swap(a.ptr, b.ptr);
+			std::swap(a.count, b.count);
+		}
+
+		// uses n elements at data without copying them, keep_alive owns the memory
+		void map(std::shared_ptr<const void> keep_alive, const T *data, const std::size_t n) {
+			owned = std::vector<T>();
+			mapping = std::move(keep_alive);
+			ptr = const_cast<T*>(data);
+			count = n;
+		}
+
+		bool is_mapped() const {
+			return (bool) mapping;
+		}
+
+		// copies mapped content into owned memory (written by the calling thread)
+		void unmap() {
+			own();
+			sync();
+		}
+
+		// modifications (std::vector interface)
+		void push_back(const T &value) {
+			own();
+			owned.push_back(value);
+			sync();
+		}
+
+		void reserve(const std::size_t n) {
+			own();
+			owned.reserve(n);
+			sync();
+		}
+
+		void resize(const std::size_t n) {
+			own();
+			owned.resize(n);
+			sync();
+		}
+
+		void assign(const std::size_t n, const T &value) {
+			mapping.reset();
+			owned.assign(n, value);
+			sync();
+		}
+
+		template<typename Iterator, typename = std::enable_if_t<!std::is_integral<Iterator>::value>>
+		void assign(Iterator first, Iterator last) {
+			std::vector<T> tmp(first, last); // the range may be the mapped content
+			mapping.reset();
+			owned = std::move(tmp);
+			sync();
+		}
+
+		// takes over the buffer of v without copying it
+		void assign(std::vector<T> &&v) {
+			mapping.reset();
+			owned = std::move(v);
+			sync();
+		}
+
+		void clear() {
+			mapping.reset();
+			owned.clear();
+			sync();
+		}
+
+		// access
+		inline std::size_t size() const {
+			return count;
+		}
+
+		inline bool empty() const {
+			return 0 == count;
+		}
+
+		inline T* data() {
+			return ptr;
+		}
+
+		inline const T* data() const {
+			return ptr;
+		}
+
+		inline T& operator[](const std::size_t index) {
+			return ptr[index];
+		}
+
+		inline const T& operator[](const std::size_t index) const {
+			return ptr[index];
+		}
+
+		inline T* begin() {
+			return ptr;
+		}
+
+		inline T* end() {
+			return ptr + count;
+		}
+
+		inline const T* begin() const {
+			return ptr;
+		}
+
+		inline const T* end() const {
+			return ptr + count;
+		}
+
+		inline const T& back() const {
+			return ptr[count - 1];
+		}
+};
+
+#endif
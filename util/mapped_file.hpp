@@ -0,0 +1,89 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+// Nur lesbare Einblendung einer ganzen Datei in den Speicher (mmap)
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+
+// all processes mapping the same file share its pages (page cache), they are loaded on first access
+class mapped_file {
+	private:
+		void *address = nullptr;
+		std::size_t length = 0;
+		std::string filename;
+
+	public:
+		// throws if the file can't be opened or mapped
+		mapped_file(const std::string &fname);
+		~mapped_file();
+
+		mapped_file(const mapped_file &other) = delete;
+		mapped_file& operator=(const mapped_file &other) = delete;
+
+		const uint8_t* data() const {
+			return (const uint8_t*) address;
+		}
+
+		std::size_t size() const {
+			return length;
+		}
+
+		const std::string& name() const {
+			return filename;
+		}
+};
+
+
+// *********************************************************************
+// Implementation:
+// *********************************************************************
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+inline mapped_file::mapped_file(const std::string &fname) : filename(fname) {
+	const int fd = open(fname.c_str(), O_RDONLY);
+	if (0 > fd) {
+		throw std::runtime_error("can't open '" + fname + "': " + std::strerror(errno));
+	}
+
+	struct stat st;
+	if (0 != fstat(fd, &st)) {
+		const int err = errno;
+		close(fd);
+		throw std::runtime_error("can't stat '" + fname + "': " + std::strerror(err));
+	}
+	length = st.st_size;
+
+	if (0 < length) {
+		address = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+		if (MAP_FAILED == address) {
+			const int err = errno;
+			address = nullptr;
+			close(fd);
+			throw std::runtime_error("can't map '" + fname + "': " + std::strerror(err));
+		}
+	}
+
+	// the mapping stays valid without the file descriptor
+	close(fd);
+}
+
+
+inline mapped_file::~mapped_file() {
+	if (nullptr != address) {
+		munmap(address, length);
+	}
+}
+
+#endif
@@ -0,0 +1,375 @@
+#ifndef NUMA_HPP
+#define NUMA_HPP
+
+// nutzbare Prozessoren (Affinitätsmaske, cgroup), ihre NUMA Knoten und Binden von Threads an Prozessoren (Linux)
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+// the NUMA nodes with cpus in the affinity mask of the process, determined once by the first call
+// (read from /sys/devices/system/node, a system without this information is one node)
+struct numa_topology {
+	std::vector<int> nodes; // ids of the nodes, ascending
+	std::vector<std::vector<int>> cpus; // usable cpus of nodes[i], ascending
+};
+
+const numa_topology& get_numa_topology();
+
+// cpus in the order in which threads are pinned: the first cpu of every node, then the second one, ...
+// so a few threads are spread over the nodes and their memory bandwidth
+std::vector<int> get_pinning_order();
+
+// number of cpus the process may use: cpus in its affinity mask, limited by the cpu quota of its cgroup
+// (cgroup v2 cpu.max or v1 cpu.cfs_quota_us, rounded up), at least 1
+unsigned int get_num_available_cpus();
+
+// wheter the affinity mask of the process contains only a part of the online cpus, i.e. the process was bound
+// to its cpus (e.g. by mpirun --bind-to, taskset or a cpuset) and isn't meant to run on every cpu
+bool is_affinity_restricted();
+
+// binds the calling thread to cpu, returns false if that's not possible
+bool pin_current_thread(const int cpu);
+
+// index into get_numa_topology().nodes of the node the calling thread runs on (0 if unknown),
+// fixed for pinned threads, otherwise the node of the current cpu
+std::size_t get_current_numa_node_index();
+
+// calls make() on a thread bound to each node, so the memory allocated and written by make() is
+// local to that node (first touch), element i of the result belongs to node index i.
+// With one node make() is called by the calling thread, an exception of make() is rethrown
+template<typename F>
+auto run_on_every_numa_node(F &&make) -> std::vector<decltype(make())>;
+
+// like run_on_every_numa_node, but make() is always called by the calling thread, which is bound to one node
+// after the other and gets its previous cpus back at the end (e.g. if only one thread should allocate the memory)
+template<typename F>
+auto run_on_every_numa_node_in_calling_thread(F &&make) -> std::vector<decltype(make())>;
+
+
+// *********************************************************************
+// Implementation:
+// *********************************************************************
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <thread>
+
+#include <pthread.h>
+#include <sched.h>
+
+
+// e.g. "0-3,8-11" (format of cpulist in sysfs)
+inline std::vector<int> parse_cpu_list(const std::string &list) {
+	std::vector<int> cpus;
+	std::istringstream iss(list);
+	std::string range;
+	while (std::getline(iss, range, ',')) {
+		int first = 0, last = 0;
+		char dash = 0;
+		std::istringstream rs(range);
+		if (!(rs >> first)) {
+			continue;
+		}
+		last = ((rs >> dash) && ('-' == dash) && (rs >> last)) ? last : first;
+		for (int cpu = first; cpu <= last; cpu++) {
+			cpus.push_back(cpu);
+		}
+	}
+	return cpus;
+}
+
+
+inline numa_topology read_numa_topology() {
+	std::vector<int> allowed;
+	cpu_set_t mask;
+	CPU_ZERO(&mask);
+	if (0 == sched_getaffinity(0, sizeof(mask), &mask)) {
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+			if (CPU_ISSET(cpu, &mask)) {
+				allowed.push_back(cpu);
+			}
+		}
+	}
+
+	numa_topology topology;
+	std::vector<int> assigned;
+	// node ids may have gaps (e.g. memory only nodes), so a few missing ids don't end the search
+	for (int node = 0, missing = 0; missing < 64; node++) {
+		std::ifstream is("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+		std::string list;
+		if (!std::getline(is, list)) {
+			missing++;
+			continue;
+		}
+		missing = 0;
+
+		std::vector<int> cpus;
+		for (int cpu : parse_cpu_list(list)) {
+			if (std::binary_search(allowed.begin(), allowed.end(), cpu)) {
+				cpus.push_back(cpu);
+				assigned.push_back(cpu);
+			}
+		}
+		if (!cpus.empty()) {
+			topology.nodes.push_back(node);
+			topology.cpus.push_back(cpus);
+		}
+	}
+
+	// no sysfs or cpus sysfs doesn't know about: everything is one node
+	std::sort(assigned.begin(), assigned.end());
+	if (topology.nodes.empty() || (assigned.size() != allowed.size())) {
+		topology.nodes = {0};
+		topology.cpus = {allowed};
+	}
+	return topology;
+}
+
+
+inline const numa_topology& get_numa_topology() {
+	static const numa_topology topology = read_numa_topology();
+	return topology;
+}
+
+
+inline std::vector<int> get_pinning_order() {
+	const numa_topology &topology = get_numa_topology();
+	std::vector<int> order;
+	for (std::size_t i = 0; ; i++) {
+		const std::size_t before = order.size();
+		for (const auto &cpus : topology.cpus) {
+			if (i < cpus.size()) {
+				order.push_back(cpus[i]);
+			}
+		}
+		if (before == order.size()) {
+			return order;
+		}
+	}
+}
+
+
+// quota / period of the cpu controller in the directory or its parents up to root, empty if not limited
+inline std::optional<double> read_cgroup_cpu_limit(std::string directory, const std::string &root, const bool v2) {
+	std::optional<double> limit;
+	while (true) {
+		double quota = -1., period = 0.;
+		if (v2) {
+			// "max 100000" or "200000 100000"
+			std::ifstream is(directory + "/cpu.max");
+			std::string q;
+			if ((is >> q >> period) && ("max" != q)) {
+				quota = std::stod(q);
+			}
+		} else {
+			std::ifstream qs(directory + "/cpu.cfs_quota_us"), ps(directory + "/cpu.cfs_period_us");
+			if (!(qs >> quota) || !(ps >> period)) {
+				quota = -1.;
+			}
+		}
+
+		if ((0. < quota) && (0. < period)) {
+			limit = std::min(limit.value_or(quota / period), quota / period);
+		}
+
+		if (directory.size() <= root.size()) {
+			return limit;
+		}
+		directory = directory.substr(0, std::max(directory.rfind('/'), root.size()));
+	}
+}
+
+
+inline unsigned int get_num_available_cpus() {
+	unsigned int num_cpus = std::max(1u, std::thread::hardware_concurrency());
+	cpu_set_t mask;
+	CPU_ZERO(&mask);
+	if (0 == sched_getaffinity(0, sizeof(mask), &mask)) {
+		num_cpus = std::max(1, CPU_COUNT(&mask));
+	}
+
+	// lines like "0::/path" (v2) or "4:cpu,cpuacct:/path" (v1), the path may not exist in a container
+	std::ifstream is("/proc/self/cgroup");
+	std::string line;
+	while (std::getline(is, line)) {
+		const std::size_t first = line.find(':'), second = line.find(':', first + 1);
+		if ((std::string::npos == first) || (std::string::npos == second)) {
+			continue;
+		}
+
+		const std::string controllers = line.substr(first + 1, second - first - 1);
+		const std::string path = line.substr(second + 1);
+		std::optional<double> limit;
+		if (controllers.empty()) {
+			limit = read_cgroup_cpu_limit("/sys/fs/cgroup" + path, "/sys/fs/cgroup", true);
+		} else if (("," + controllers + ",").find(",cpu,") != std::string::npos) {
+			const std::string root = "/sys/fs/cgroup/" + controllers;
+			limit = read_cgroup_cpu_limit(root + path, root, false);
+			if (!limit) {
+				limit = read_cgroup_cpu_limit("/sys/fs/cgroup/cpu" + path, "/sys/fs/cgroup/cpu", false);
+			}
+		}
+
+		if (limit) {
+			num_cpus = std::min(num_cpus, std::max(1u, (unsigned int) std::ceil(*limit)));
+		}
+	}
+	return num_cpus;
+}
+
+
+inline bool is_affinity_restricted() {
+	std::size_t num_online = std::thread::hardware_concurrency();
+	std::ifstream is("/sys/devices/system/cpu/online");
+	std::string list;
+	if (std::getline(is, list)) {
+		num_online = parse_cpu_list(list).size();
+	}
+
+	std::size_t num_allowed = 0;
+	for (const auto &cpus : get_numa_topology().cpus) {
+		num_allowed += cpus.size();
+	}
+	return num_allowed < num_online;
+}
+
+
+// node index of a thread bound to the cpus of one node, otherwise empty
+inline std::optional<std::size_t>& pinned_numa_node_index() {
+	static thread_local std::optional<std::size_t> index;
+	return index;
+}
+
+
+inline bool pin_current_thread_to_cpus(const std::vector<int> &cpus) {
+	cpu_set_t mask;
+	CPU_ZERO(&mask);
+	for (int cpu : cpus) {
+		if ((0 <= cpu) && (cpu < CPU_SETSIZE)) {
+			CPU_SET(cpu, &mask);
+		}
+	}
+
+	if ((0 == CPU_COUNT(&mask)) || (0 != pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask))) {
+		return false;
+	}
+
+	const numa_topology &topology = get_numa_topology();
+	pinned_numa_node_index().reset();
+	for (std::size_t i = 0; i < topology.cpus.size(); i++) {
+		const auto &node_cpus = topology.cpus[i];
+		if (std::all_of(cpus.begin(), cpus.end(), [&](int cpu) {
+			return std::binary_search(node_cpus.begin(), node_cpus.end(), cpu); }))
+		{
+			pinned_numa_node_index() = i;
+		}
+	}
+	return true;
+}
+
+
+inline bool pin_current_thread(const int cpu) {
+	return pin_current_thread_to_cpus({cpu});
+}
+
+
+inline std::size_t get_current_numa_node_index() {
+	if (pinned_numa_node_index()) {
+		return *pinned_numa_node_index();
+	}
+
+	const numa_topology &topology = get_numa_topology();
+	if (1 < topology.nodes.size()) {
+		const int cpu = sched_getcpu();
+		for (std::size_t i = 0; i < topology.cpus.size(); i++) {
+			if (std::binary_search(topology.cpus[i].begin(), topology.cpus[i].end(), cpu)) {
+				return i;
+			}
+		}
+	}
+	return 0;
+}
+
+
+template<typename F>
+auto run_on_every_numa_node(F &&make) -> std::vector<decltype(make())> {
+	using result_t = decltype(make());
+	const numa_topology &topology = get_numa_topology();
+
+	if (1 >= topology.nodes.size()) {
+		return {make()};
+	}
+
+	std::vector<std::optional<result_t>> results(topology.nodes.size());
+	std::vector<std::exception_ptr> errors(topology.nodes.size());
+	std::vector<std::thread> threads;
+	for (std::size_t i = 0; i < topology.nodes.size(); i++) {
+		threads.emplace_back([&, i]() {
+			try {
+				// not being able to bind the thread only costs performance
+				pin_current_thread_to_cpus(topology.cpus[i]);
+				results[i] = make();
+			} catch (...) {
+				errors[i] = std::current_exception();
+			}
+		});
+	}
+
+	for (auto &t : threads) {
+		t.join();
+	}
+
+	std::vector<result_t> replicas;
+	for (std::size_t i = 0; i < results.size(); i++) {
+		if (errors[i]) {
+			std::rethrow_exception(errors[i]);
+		}
+		replicas.push_back(std::move(*results[i]));
+	}
+	return replicas;
+}
+
+
+template<typename F>
+auto run_on_every_numa_node_in_calling_thread(F &&make) -> std::vector<decltype(make())> {
+	const numa_topology &topology = get_numa_topology();
+
+	if (1 >= topology.nodes.size()) {
+		return {make()};
+	}
+
+	cpu_set_t previous;
+	CPU_ZERO(&previous);
+	const bool restore = (0 == pthread_getaffinity_np(pthread_self(), sizeof(previous), &previous));
+	const std::optional<std::size_t> previous_node = pinned_numa_node_index();
+
+	std::vector<decltype(make())> replicas;
+	std::exception_ptr error;
+	try {
+		for (const auto &cpus : topology.cpus) {
+			// not being able to bind the thread only costs performance
+			pin_current_thread_to_cpus(cpus);
+			replicas.push_back(make());
+		}
+	} catch (...) {
+		error = std::current_exception();
+	}
+
+	if (restore) {
+		pthread_setaffinity_np(pthread_self(), sizeof(previous), &previous);
+	}
+	pinned_numa_node_index() = previous_node;
+
+	if (error) {
+		std::rethrow_exception(error);
+	}
+	return replicas;
+}
+
+#endif
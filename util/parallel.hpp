@@ -0,0 +1,54 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+// Hilfsfunktion zur parallelen Bearbeitung eines Indexbereichs mit mehreren Threads
+
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+
+// calls f(first, last, part) for num_parts consecutive parts of [0, n) with one thread per part,
+// the calling thread processes part 0, the first exception of a part is rethrown after all parts are done
+template<typename F>
+void parallel_for(const std::size_t n, const unsigned num_parts, F &&f);
+
+
+// *********************************************************************
+// Implementation:
+// *********************************************************************
+
+template<typename F>
+void parallel_for(const std::size_t n, const unsigned num_parts, F &&f) {
+	const unsigned parts = (0 < num_parts) ? num_parts : 1;
+	std::vector<std::exception_ptr> errors(parts);
+
+	auto run_part = [&](const unsigned part) {
+		try {
+			f(n * part / parts, n * (part + 1) / parts, part);
+		} catch (...) {
+			errors[part] = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(parts - 1);
+	for (unsigned part = 1; part < parts; part++) {
+		threads.emplace_back(run_part, part);
+	}
+
+	run_part(0);
+
+	for (auto &t : threads) {
+		t.join();
+	}
+
+	for (const auto &error : errors) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+}
+
+#endif
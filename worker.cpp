@@ -27,6 +27,21 @@ int main(int argc, char **argv)
 			throw std::runtime_error("name for problem instance required!");
 		
 		const char *server_name = argv[1];
+
+		param_parse_registry["--restart"] = &parse_restart_policy;
+		param_parse_registry["--restartBase"] = &parse_restart_base;
+		param_parse_registry["--restartFactor"] = &parse_restart_factor;
+		param_parse_registry["--restartPerturbation"] = &parse_restart_perturbation;
+		param_parse_registry["--restartFromBest"] = &parse_restart_from_best;
+		param_parse_registry["--formulaCache"] = &parse_formula_cache_size;
+		param_parse_registry["--sharedFormulaDir"] = &parse_shared_formula_directory;
+		param_parse_registry["--noThreadPinning"] = &parse_no_thread_pinning;
+		param_parse_registry["--threads"] = &parse_num_probsat_threads;
+
+		int params_left = parse_params(argc - 2, &argv[2]);
+		if (0 != params_left) {
+			throw std::runtime_error("invalid worker arguments!");
+		}
 		
 		// MPI_Init(&argc, &argv);
 		int provided;
@@ -41,8 +56,15 @@ int main(int argc, char **argv)
 			assert(0 != is_initialized);
 		}
 
-		// unsigned int num_workers = std::max((int)std::thread::hardware_concurrency() - 1, 1);
-		unsigned int num_workers = NUM_PROBSAT_THREADS_PER_WORKER;
+		// the nodes may differ, so the default is determined here and not at compile time
+		const unsigned int num_workers = (0 < num_probsat_threads) ? num_probsat_threads : get_num_available_cpus();
+		#if USE_FIX_CNF_GLOBAL_INPUT_READING
+			// the formula memory is only allocated by the main thread (see config.hpp)
+			num_parser_threads() = 1;
+		#else
+			// large formulas are parsed with the threads of this worker, not with all threads of the node
+			num_parser_threads() = num_workers;
+		#endif
 
 		int length = 0;
 		char processor_name[MPI_MAX_PROCESSOR_NAME];
@@ -81,8 +103,36 @@ int main(int argc, char **argv)
 		// using namespace std::chrono_literals;
 		// std::this_thread::sleep_for(500ms);
 
+		#if USE_THREAD_PINNING
+			// with more threads than cpus several threads share a cpu
+			const std::vector<int> cpus = get_pinning_order();
+			const long first_cpu = get_first_pinned_cpu(num_workers, cpus.size());
+
+			#if DEBUG_WORKER
+				if (pin_threads && (0 > first_cpu)) {
+					std::cout << msg_header << "threads are not pinned, the cpus are shared with other processes" << std::endl;
+				}
+			#endif
+
+			#if USE_NUMA_REPLICATION
+				// only pinned threads stay on the node of their copy
+				replicate_formulas = pin_threads && !cpus.empty() && (0 <= first_cpu);
+			#endif
+		#endif
+
 		std::vector<std::thread> workers;
 		for (uint i = 0; i < num_workers; i++) {
+			#if USE_THREAD_PINNING
+				if (pin_threads && !cpus.empty() && (0 <= first_cpu)) {
+					workers.push_back(std::thread([cpu = cpus[(first_cpu + i) % cpus.size()]]() {
+						if (!pin_current_thread(cpu)) {
+							std::cerr << msg_header << "can't bind thread to cpu " << cpu << std::endl;
+						}
+						worker_func();
+					}));
+					continue;
+				}
+			#endif
 			workers.push_back(std::thread(worker_func));
 		}
 
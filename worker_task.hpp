@@ -6,18 +6,29 @@
 #include "config.hpp"
 
 #include "util/util.hpp"
-#include "sat/3sat-clause.hpp"
+#include "util/parse_params.hpp"
 #include "sat/instance.hpp"
+#include "sat/dispatch.hpp"
+#include "sat/shared_formula.hpp"
 #include "sat/probability_functions/polynomial.hpp"
 #include "sat/probability_functions/exponential.hpp"
 #include "sat/probability_functions/cached.hpp"
+#include "sat/probability_functions/table.hpp"
+#include "util/bitfield.hpp"
+#include "util/file_cache.hpp"
+#include "util/numa.hpp"
 
 // #include "communication/worker.hpp"
 #include "communication/cmd/ws_typedefs.hpp"
 
 #include <chrono>
 #include <cmath>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <queue>
+#include <sstream>
+#include <string>
 #include <thread>
 #include <condition_variable>
 
@@ -28,6 +39,25 @@ auto sleep_duration_between_get_task_polls = std::chrono::milliseconds(10);
 
 std::size_t default_max_flips = 20000000;
 
+// restarts within one task: the instance is reset with a new assignment and seed
+// instead of returning the task and getting a new one from the server
+// max_flips of a task is the budget for all of its tries
+enum class restart_policy {
+	none, // one try per task
+	fixed, // tries of restart_base flips
+	luby, // tries of restart_base * luby(i) flips (1, 1, 2, 1, 1, 2, 4, ...)
+	geometric // tries of restart_base * restart_factor^i flips
+};
+
+restart_policy task_restart_policy = restart_policy::none;
+std::size_t restart_base = 100000;
+double restart_factor = 2.;
+// if greater zero a restart keeps the current assignment and flips this fraction of the variables
+// (incremental, instead of a new random assignment)
+double restart_perturbation = 0.;
+// perturb the best assignment of the last try instead of the current one (requires TRACK_BEST_ASSIGNMENT)
+bool restart_from_best = false;
+
 // algorithm options:
 constexpr bool caching = true;
 
@@ -41,55 +71,266 @@ constexpr bool caching = true;
 #endif
 
 // data type specialications:
-using num_t = int32_t;
-using sum_t = int32_t;
-using cnt_t = int16_t;
+// num_t, sum_t, cnt_t and the clause type are chosen per formula by load_cnf_formula (sat/dispatch.hpp)
 using prec_t = double;
 
+// #define DEBUG_WORKER_OUTPUT 1
 
-#define USE_ONLY_3SAT_CLAUSES 0
 
-#if USE_ONLY_3SAT_CLAUSES
-	#include "sat/3sat-clause.hpp"
-	using clause_t = static_clause_3sat<num_t, 4>;
+template<typename num_t>
+using poly_prob_func_t = prob_func_polynomial<num_t, prec_t>;
+template<typename num_t>
+using exp_prob_func_t = prob_func_exponential<num_t, prec_t>;
+
+#if USE_PROB_FUNC_TABLE
+	template<typename num_t>
+	using prob_func_t = prob_func_table<num_t, prec_t, poly_prob_func_t<num_t>>;
+#elif USE_CACHED_PROB_FUNC
+	template<typename num_t>
+	using prob_func_t = prob_func_cached<num_t, prec_t, poly_prob_func_t<num_t>, multithreaded, manythreads>;
 #else
-	#include "sat/clause.hpp"
-	using clause_t = generic_clause<num_t>;
+	template<typename num_t>
+	using prob_func_t = poly_prob_func_t<num_t>;
 #endif
 
-// #define DEBUG_WORKER_OUTPUT 1
-
+using random_generator_t = lin_cong_random_generator;
 
-using cnf_formula_t = cnf_formula<num_t, sum_t, cnt_t, clause_t>;
+template<class formula_t>
+using serial_instance_t = serial_instance<typename formula_t::num_type, typename formula_t::sum_type, typename formula_t::cnt_type,
+	prec_t, typename formula_t::clause_type, prob_func_t<typename formula_t::num_type>, random_generator_t, caching>;
 
-using poly_prob_func_t = prob_func_polynomial<num_t, prec_t>;
-using exp_prob_func_t = prob_func_exponential<num_t, prec_t>;
 
-#if USE_CACHED_PROB_FUNC
-	using prob_func_t = prob_func_cached<num_t, prec_t, poly_prob_func_t, multithreaded, manythreads>;
+#if USE_PROB_FUNC_TABLE
+	// the table depends on the formula, so it is created per job (see create_tasks)
+	template<class formula_t>
+	std::shared_ptr<prob_func_t<typename formula_t::num_type>> make_prob_func(const formula_t &bformula) {
+		using num_t = typename formula_t::num_type;
+		return std::make_shared<prob_func_t<num_t>>(poly_prob_func_t<num_t>(), bformula.get_max_num_breaks_possible());
+	}
 #else
-	using prob_func_t = poly_prob_func_t;
+	// one probability function per num_t for all formulas (per thread with USE_PROB_FUNC_LOCAL_CACHE)
+	template<typename num_t>
+	prob_func_t<num_t>& get_shared_prob_func() {
+		#if USE_PROB_FUNC_LOCAL_CACHE
+			thread_local static prob_func_t<num_t> tl_pfi = prob_func_t<num_t>();
+			return tl_pfi;
+		#else
+			static prob_func_t<num_t> global_pfi = prob_func_t<num_t>();
+			return global_pfi;
+		#endif
+	}
 #endif
 
-using random_generator_t = lin_cong_random_generator;
-using serial_instance_t = serial_instance<num_t, sum_t, cnt_t, prec_t, clause_t, prob_func_t, random_generator_t, caching>;
 
+// worker parameters (given to add_workers of the manager)
+void parse_restart_policy(std::queue<std::string> &params) {
+	params.pop();
+
+	if (params.empty()) {
+		throw std::runtime_error("restart policy is required");
+	}
+
+	std::string p = params.front();
+	if ("none" == p) {
+		task_restart_policy = restart_policy::none;
+	} else if ("fixed" == p) {
+		task_restart_policy = restart_policy::fixed;
+	} else if ("luby" == p) {
+		task_restart_policy = restart_policy::luby;
+	} else if ("geometric" == p) {
+		task_restart_policy = restart_policy::geometric;
+	} else {
+		throw std::runtime_error("unknown restart policy '" + p + "'");
+	}
+
+	params.pop();
+}
+
+void parse_restart_base(std::queue<std::string> &params) {
+	params.pop();
 
-static prob_func_t global_pfi = prob_func_t();
-// thread_local prob_func_t global_pfi = prob_func_t();
+	if (params.empty()) {
+		throw std::runtime_error("number of flips is required");
+	}
+
+	std::istringstream iss(params.front());
+	iss >> restart_base;
+	if ((!iss) || (0 == restart_base)) {
+		throw std::runtime_error("can't parse '" + params.front() + "' as number of flips");
+	}
+
+	params.pop();
+}
+
+void parse_restart_factor(std::queue<std::string> &params) {
+	params.pop();
+
+	if (params.empty()) {
+		throw std::runtime_error("restart factor is required");
+	}
+
+	std::istringstream iss(params.front());
+	iss >> restart_factor;
+	if ((!iss) || (1. > restart_factor)) {
+		throw std::runtime_error("can't parse '" + params.front() + "' as restart factor >= 1");
+	}
+
+	params.pop();
+}
+
+
+void parse_restart_perturbation(std::queue<std::string> &params) {
+	params.pop();
+
+	if (params.empty()) {
+		throw std::runtime_error("percentage of variables is required");
+	}
+
+	std::istringstream iss(params.front());
+	double percentage = 0.;
+	iss >> percentage;
+	if ((!iss) || (0. > percentage) || (100. < percentage)) {
+		throw std::runtime_error("can't parse '" + params.front() + "' as percentage of variables");
+	}
+	restart_perturbation = percentage / 100.;
+
+	params.pop();
+}
+
+
+class task;
+
+// the cached function keeps the formula and its probability function alive, see make_solver_run
+file_cache<std::function<void(task&)>> formula_cache(((std::size_t) FORMULA_CACHE_SIZE_MB) << 20);
+
+void parse_formula_cache_size(std::queue<std::string> &params) {
+	params.pop();
+
+	if (params.empty()) {
+		throw std::runtime_error("cache size in MiB is required");
+	}
+
+	std::istringstream iss(params.front());
+	std::size_t size_mb = 0;
+	iss >> size_mb;
+	if (!iss) {
+		throw std::runtime_error("can't parse '" + params.front() + "' as cache size in MiB");
+	}
+	formula_cache.set_budget(size_mb << 20);
+
+	params.pop();
+}
+
+
+// number of probsat threads of the worker, 0: one per available cpu (see get_num_available_cpus)
+unsigned int num_probsat_threads = NUM_PROBSAT_THREADS_PER_WORKER;
+
+void parse_num_probsat_threads(std::queue<std::string> &params) {
+	params.pop();
+
+	if (params.empty()) {
+		throw std::runtime_error("number of threads is required (0 for one per available cpu)");
+	}
+
+	// signed, so that e.g. -1 isn't read as 2^32 - 1, more threads than a few per cpu only compete for the cpus
+	std::istringstream iss(params.front());
+	long long threads = -1;
+	iss >> threads;
+	const long long max_threads = 4 * (long long) get_num_available_cpus();
+	if (!iss || (0 > threads) || (max_threads < threads)) {
+		throw std::runtime_error("can't parse '" + params.front() + "' as number of threads (0 to " + std::to_string(max_threads) + ")");
+	}
+	num_probsat_threads = (unsigned int) threads;
+
+	params.pop();
+}
+
+
+// the probsat threads are bound to cpus, see worker.cpp
+bool pin_threads = USE_THREAD_PINNING;
+
+void parse_no_thread_pinning(std::queue<std::string> &params) {
+	params.pop();
+	pin_threads = false;
+}
+
+
+// formulas are shared with the other workers of the node through this directory, see load_shared_cnf_formula
+std::string shared_formula_directory = SHARED_FORMULA_DIRECTORY;
+
+void parse_shared_formula_directory(std::queue<std::string> &params) {
+	params.pop();
+
+	if (params.empty()) {
+		throw std::runtime_error("directory for shared formulas is required (\"\" disables the sharing)");
+	}
+
+	shared_formula_directory = params.front();
+	params.pop();
+}
+
+
+void parse_restart_from_best(std::queue<std::string> &params) {
+	params.pop();
+	#if !TRACK_BEST_ASSIGNMENT
+		throw std::runtime_error("restarts from the best assignment require TRACK_BEST_ASSIGNMENT");
+	#endif
+	restart_from_best = true;
+}
+
+
+// i-th element (starting with 1) of the luby sequence
+std::size_t luby(std::size_t i) {
+	assert(0 < i);
+	std::size_t power = 1; // 2^k
+	while (true) {
+		while (2 * power - 1 < i) {
+			power *= 2;
+		}
+		if (2 * power - 1 == i) {
+			return power;
+		}
+		// i is in the second copy of the sequence before 2 * power - 1
+		i -= power - 1;
+		power = 1;
+	}
+}
+
+
+// maximum number of flips of the try with the given index (starting with 0)
+std::size_t get_try_length(const std::size_t try_index) {
+	switch (task_restart_policy) {
+		case restart_policy::fixed:
+			return restart_base;
+		case restart_policy::luby:
+			return restart_base * luby(try_index + 1);
+		case restart_policy::geometric: {
+			const double length = restart_base * std::pow(restart_factor, (double) try_index);
+			return (length < (double) std::numeric_limits<std::size_t>::max())
+				? (std::size_t) length : std::numeric_limits<std::size_t>::max();
+		}
+		default:
+			return std::numeric_limits<std::size_t>::max();
+	}
+}
 
 
 class task {
 	public:
 		std::size_t max_flips;
-		std::shared_ptr<cnf_formula_t> cnf_sptr;
 		done_processing_info dpi;
 		std::string name;
 
-		prob_func_t *pfi_ptr;
+		// calls solve with the formula of the job (and its probability function), see make_solver_run
+		std::function<void(task&)> run_solver;
+
+		#if TRACK_BEST_ASSIGNMENT
+			bitfield<int64_t> best_assignment; // of the try with dpi.min_unsat_clauses if unsolved, streamed to the server
+		#endif
+		bitfield<int64_t> model; // satisfying assignment if dpi.solved, streamed to the server
 
-		task(const problem_instance_metadata &pim, std::shared_ptr<cnf_formula_t> cnf, const uint32_t task_id, prob_func_t *pf = &global_pfi) :
-			max_flips(default_max_flips), cnf_sptr(cnf), dpi(), name(pim.filename), pfi_ptr(pf)
+		task(const problem_instance_metadata &pim, const std::function<void(task&)> &run, const uint32_t task_id) :
+			max_flips(default_max_flips), dpi(), name(pim.filename), run_solver(run)
 		{
 			dpi.solved = false;
 			dpi.task_id = task_id;
@@ -98,116 +339,207 @@ class task {
 			}
 		}
 		
-		// task(const task &o) : max_flips(o.max_flips), cnf_sptr(o.cnf_sptr), dpi(o.dpi), name(o.name), pfi(o.pfi) {}
 		task(const task &other) = delete;
 
+		template<class formula_t, class pf_t>
+		void solve(const formula_t &bformula, pf_t &pfi);
+
 		void execute() {
-			auto start = std::chrono::high_resolution_clock::now();
+			start = std::chrono::high_resolution_clock::now();
 
 			try {
 				#if DEBUG_WORKER_OUTPUT
 					std::cout << msg_header << "c processing: " << name << std::endl;
 				#endif
 
-				assert(nullptr != cnf_sptr.get());
+				assert(run_solver);
+				run_solver(*this);
+			} catch (const std::exception& ex) {
+				print_exception(msg_header, ex);
+				return;
+			}
 
-				#if ENALBE_CNF_MULTITHREAD_SHARING
-				#else
-					static_assert(false);
-				#endif
+			auto done = std::chrono::high_resolution_clock::now();
+			auto overall_duration = std::chrono::duration_cast<std::chrono::seconds>(done - start);
+			dpi.overall_duration = std::chrono::duration_cast<std::chrono::microseconds>(done - start).count();
+			#if DEBUG_WORKER_OUTPUT
+				std::cout << msg_header << "c overall duration: " << overall_duration.count() << " seconds" << std::endl;
+			#endif
 
-				prob_func_t &pfi = *pfi_ptr;
+			dpi.instances_processed = 1;
+		}
 
-				// requires ENALBE_CNF_MULTITHREAD_SHARING to be defined as 1 for correct multithreading
-				// bformula.initialize();
-				cnf_sptr->initialize();
-				const cnf_formula_t &bformula = *(cnf_sptr.get());
-				// bformula.debug_output_formula();
+	private:
+		std::chrono::high_resolution_clock::time_point start;
+};
 
-				dpi.num_vars = bformula.num_vars();
-				dpi.num_clauses = bformula.num_clauses();
 
-				random_generator_t rgen = random_generator_t();
-				dpi.seed = rgen.get_seed();
-				#if DEBUG_WORKER_OUTPUT
-					std::cout << msg_header << "c seed = " << std::to_string(rgen.get_seed()) << std::endl;
-				#endif
+template<class formula_t, class pf_t>
+void task::solve(const formula_t &bformula, pf_t &pfi) {
+	using instance_t = serial_instance_t<formula_t>;
 
-				auto belegung = serial_instance_t::configuration_type(bformula.num_vars());
-				// for (num_t i = 0; i < bformula.num_vars(); i++) {belegung[i] = 0;}
-				for (num_t i = 0; i < bformula.num_vars(); i++) {belegung[i] = rgen.rand() % 2;}
+	#if DEBUG_WORKER_OUTPUT
+		std::cout << msg_header << "c data types: " << describe_types(bformula) << std::endl;
+	#endif
 
-				serial_instance_t solver = serial_instance_t(bformula, pfi, belegung, rgen);
+	dpi.num_vars = bformula.num_vars();
+	dpi.num_clauses = bformula.num_clauses();
 
+	// try i uses seed + i, so every try can be reproduced from the reported seed (without perturbation)
+	random_generator_t rgen = random_generator_t();
+	const auto first_seed = rgen.get_seed();
+	dpi.seed = first_seed;
+	#if DEBUG_WORKER_OUTPUT
+		std::cout << msg_header << "c seed = " << std::to_string(rgen.get_seed()) << std::endl;
+	#endif
 
-				auto initialized = std::chrono::high_resolution_clock::now();
-				auto initialization_duration = std::chrono::duration_cast<std::chrono::milliseconds>(initialized - start);
-				dpi.init_duration = std::chrono::duration_cast<std::chrono::microseconds>(initialized - start).count();
-				#if DEBUG_WORKER_OUTPUT
-					std::cout << msg_header << "c initialization duration: " << initialization_duration.count() << " ms" << std::endl;
-				#endif
+	auto belegung = typename instance_t::configuration_type(bformula.num_vars());
+	for (typename formula_t::num_type i = 0; i < bformula.num_vars(); i++) {belegung[i] = rgen.rand() % 2;}
 
+	instance_t solver = instance_t(bformula, pfi, belegung, rgen);
 
-				auto start_solving = std::chrono::high_resolution_clock::now();
 
-				while (!solver.found_solution()) {
-					solver.do_flip();
-					
-					if (max_flips <= solver.get_num_flips()) {
-						#if DEBUG_WORKER_OUTPUT
-							std::cout << msg_header << "c FOUND NO SOLUTION AFTER " << solver.get_num_flips() << " FLIPS!" << std::endl;
-						#endif
-						break;
-					}
-					
-					// if (!running) return;
-					if (!running)
-						break;
-				}
+	auto initialized = std::chrono::high_resolution_clock::now();
+	auto initialization_duration = std::chrono::duration_cast<std::chrono::milliseconds>(initialized - start);
+	dpi.init_duration = std::chrono::duration_cast<std::chrono::microseconds>(initialized - start).count();
+	#if DEBUG_WORKER_OUTPUT
+		std::cout << msg_header << "c initialization duration: " << initialization_duration.count() << " ms" << std::endl;
+	#endif
 
-				auto done_solving = std::chrono::high_resolution_clock::now();
-				auto duration = std::chrono::duration_cast<std::chrono::microseconds>(done_solving - start_solving).count();
-				dpi.solve_duration = std::chrono::duration_cast<std::chrono::microseconds>(done_solving - start_solving).count();
 
-				auto num_flips = solver.get_num_flips();
-				double fps = ((float) num_flips) / duration * 1000000.;
-				
-				dpi.num_flips_done = num_flips;
-				dpi.flips_per_second = fps;
+	auto start_solving = std::chrono::high_resolution_clock::now();
 
-				#if DEBUG_WORKER_OUTPUT
-					std::cout << msg_header << "c done after " << num_flips << " flips and " << round(duration/1000.) << " milliseconds" << std::endl;
-					std::cout << msg_header << "c => " << round(fps) << " flips per seconds" << std::endl;
+	std::size_t num_flips = 0; // of all tries
+	for (std::size_t try_index = 0; ; try_index++) {
+		if (0 < try_index) {
+			rgen.reseed(first_seed + try_index);
+			dpi.seed = rgen.get_seed();
+			if (0. < restart_perturbation) {
+				#if TRACK_BEST_ASSIGNMENT
+					if (restart_from_best) {
+						solver.restore_best();
+					}
 				#endif
-				
-				if (solver.found_solution()) {
-					assert(solver.check_assignment());
-					dpi.solved = true;
-					#if DEBUG_WORKER_OUTPUT
-						std::cout << msg_header << "s SATISFIABLE" << std::endl;
-					#endif
+				solver.perturb(restart_perturbation);
+			} else {
+				for (typename formula_t::num_type i = 0; i < bformula.num_vars(); i++) {belegung[i] = rgen.rand() % 2;}
+				solver.reset(belegung);
+			}
+		}
+
+		const std::size_t try_flips = std::min(get_try_length(try_index), max_flips - num_flips);
+
+		// the termination conditions are only checked between batches of flips
+		while (!solver.found_solution()) {
+			if (try_flips <= solver.get_num_flips()) {
+				break;
+			}
+			
+			if (!running)
+				break;
+
+			solver.do_flips(std::min<std::size_t>(FLIP_BATCH_SIZE, try_flips - solver.get_num_flips()));
+		}
+
+		num_flips += solver.get_num_flips();
+
+		#if TRACK_BEST_ASSIGNMENT
+			if (solver.get_min_number_of_unsat_clauses() < dpi.min_unsat_clauses) {
+				dpi.min_unsat_clauses = solver.get_min_number_of_unsat_clauses();
+				dpi.min_unsat_flips = solver.get_min_number_of_unsat_clauses_flips();
+				dpi.min_unsat_seed = dpi.seed;
+
+				// a solution is sent as model instead
+				if (!solver.found_solution()) {
+					const auto best = solver.get_best_assignment();
+					best_assignment = bitfield<int64_t>(bformula.num_vars());
+					for (typename formula_t::num_type i = 0; i < bformula.num_vars(); i++) {best_assignment.set(i, best[i]);}
 				}
-				
-				// should prevent cnf_sptr getting optimized away while cnf_sptr.get() is in usage
-				volatile auto a = (0 < cnf_sptr.use_count());
-				assert(0 < a); ignore(a);
-			} catch (const std::exception& ex) {
-				print_exception(msg_header, ex);
-				return;
 			}
+		#else
+			if (solver.get_number_of_unsat_clauses() < dpi.min_unsat_clauses) {
+				dpi.min_unsat_clauses = solver.get_number_of_unsat_clauses();
+				dpi.min_unsat_flips = solver.get_num_flips();
+				dpi.min_unsat_seed = dpi.seed;
+			}
+		#endif
+		if (solver.found_solution() || (max_flips <= num_flips) || !running) {
+			break;
+		}
+	}
 
-			auto done = std::chrono::high_resolution_clock::now();
-			auto overall_duration = std::chrono::duration_cast<std::chrono::seconds>(done - start);
-			dpi.overall_duration = std::chrono::duration_cast<std::chrono::microseconds>(done - start).count();
-			#if DEBUG_WORKER_OUTPUT
-				std::cout << msg_header << "c overall duration: " << overall_duration.count() << " seconds" << std::endl;
-			#endif
+	#if DEBUG_WORKER_OUTPUT
+		if (!solver.found_solution()) {
+			std::cout << msg_header << "c FOUND NO SOLUTION AFTER " << num_flips << " FLIPS!" << std::endl;
+		}
+	#endif
 
-			// should prevent cnf_sptr getting optimized away while cnf_sptr.get() is in usage
-			dpi.instances_processed = (nullptr != cnf_sptr.get());
-			assert(dpi.instances_processed == 1);
+	auto done_solving = std::chrono::high_resolution_clock::now();
+	auto duration = std::chrono::duration_cast<std::chrono::microseconds>(done_solving - start_solving).count();
+	dpi.solve_duration = std::chrono::duration_cast<std::chrono::microseconds>(done_solving - start_solving).count();
+
+	double fps = ((float) num_flips) / duration * 1000000.;
+	
+	dpi.num_flips_done = num_flips;
+	dpi.flips_per_second = fps;
+
+	#if DEBUG_WORKER_OUTPUT
+		std::cout << msg_header << "c done after " << num_flips << " flips and " << round(duration/1000.) << " milliseconds" << std::endl;
+		std::cout << msg_header << "c => " << round(fps) << " flips per seconds" << std::endl;
+	#endif
+	
+	if (solver.found_solution()) {
+		assert(solver.check_assignment());
+		dpi.solved = true;
+
+		const auto &assignment = solver.get_assignment();
+		model = bitfield<int64_t>(bformula.num_vars());
+		for (typename formula_t::num_type i = 0; i < bformula.num_vars(); i++) {model.set(i, assignment[i]);}
+		#if DEBUG_WORKER_OUTPUT
+			std::cout << msg_header << "s SATISFIABLE" << std::endl;
+		#endif
+	}
+}
+
+
+// the returned function keeps the formula (and the probability function) alive as long as a task uses it
+template<class formula_t>
+std::function<void(task&)> make_solver_run(const std::shared_ptr<const formula_t> &cnf_sptr) {
+	#if USE_PROB_FUNC_TABLE
+		auto pfi_sptr = make_prob_func(*cnf_sptr);
+		return [cnf_sptr, pfi_sptr](task &t) { t.solve(*cnf_sptr, *pfi_sptr); };
+	#else
+		return [cnf_sptr](task &t) { t.solve(*cnf_sptr, get_shared_prob_func<typename formula_t::num_type>()); };
+	#endif
+}
+
+
+#if USE_NUMA_REPLICATION
+	// wheter create_tasks replicates the formulas per NUMA node, set by worker.cpp if the threads are pinned,
+	// otherwise all threads use one formula (e.g. the image shared with the other workers, see load_shared_cnf_formula)
+	bool replicate_formulas = false;
+
+	// like make_solver_run, but every NUMA node of the worker gets its own copy of the formula (and the probability table)
+	// and a task uses the copy of the node it runs on. With one node the formula isn't copied
+	template<class formula_t>
+	std::function<void(task&)> make_replicated_solver_run(const std::shared_ptr<const formula_t> &cnf_sptr) {
+		if (2 > get_numa_topology().nodes.size()) {
+			return make_solver_run(cnf_sptr);
 		}
-};
+
+		auto make_copy = [&]() {
+			return make_solver_run(std::shared_ptr<const formula_t>(cnf_sptr->make_local_copy()));
+		};
+
+		#if USE_FIX_CNF_GLOBAL_INPUT_READING
+			// the formula memory is only allocated by the main thread (see config.hpp), which visits every node
+			const auto runs = std::make_shared<const std::vector<std::function<void(task&)>>>(run_on_every_numa_node_in_calling_thread(make_copy));
+		#else
+			const auto runs = std::make_shared<const std::vector<std::function<void(task&)>>>(run_on_every_numa_node(make_copy));
+		#endif
+		return [runs](task &t) { (*runs)[get_current_numa_node_index()](t); };
+	}
+#endif
 
 
 std::mutex task_mutex;
@@ -228,32 +560,50 @@ void create_tasks(std::vector<job> jobs) {
 		assert(0 < j.num_instances_to_start);
 
 		#if USE_CNF_MULTITHREAD_SHARING
-			auto cnf_sptr = std::make_shared<cnf_formula_t>(j.metadata.filename, false);
-			// std::cout << "POINTER: " << cnf_sptr.get() << std::endl;
-
-			#if USE_FIX_CNF_GLOBAL_INPUT_READING
-				cnf_sptr->initialize();
-			#endif
-			
-			{ // task_mutex.lock();
-				std::lock_guard<std::mutex> lock(task_mutex);
-				for (uint32_t i = 0; i < j.num_instances_to_start; i++) {
-					tasks.push_back(std::make_shared<task>(j.metadata, cnf_sptr, j.task_id));
-				}
-
-				instances_to_get -= j.num_instances_to_start;
-			} // task_mutex.unlock();
+			// the formula is loaded once and shared read only by all tasks of the job,
+			// later jobs of the same (unchanged) file reuse it while it's in the cache
+			std::function<void(task&)> run = formula_cache.get(j.metadata.filename, [](const std::string &filename) {
+				std::pair<std::function<void(task&)>, std::size_t> loaded;
+				load_shared_cnf_formula(filename, [&](const auto cnf_sptr) {
+					#if USE_NUMA_REPLICATION
+						if (replicate_formulas) {
+							loaded = {make_replicated_solver_run(cnf_sptr), cnf_sptr->get_memory_usage() * get_numa_topology().nodes.size()};
+							return;
+						}
+					#endif
+					loaded = {make_solver_run(cnf_sptr), cnf_sptr->get_memory_usage()};
+				}, shared_formula_directory);
+				return loaded;
+			});
+			std::vector<std::function<void(task&)>> runs(j.num_instances_to_start, run);
+		#elif USE_FIX_CNF_GLOBAL_INPUT_READING
+			// every task gets its own copy of the formula, loaded here by the main thread
+			std::vector<std::function<void(task&)>> runs;
+			for (uint32_t i = 0; i < j.num_instances_to_start; i++) {
+				load_shared_cnf_formula(j.metadata.filename, [&](const auto cnf_sptr) {
+					runs.push_back(make_solver_run(cnf_sptr));
+				}, shared_formula_directory);
+			}
 		#else
-			{ // task_mutex.lock();
-				std::lock_guard<std::mutex> lock(task_mutex);
-				for (uint32_t i = 0; i < j.num_instances_to_start; i++) {
-					tasks.push_back(std::make_shared<task>(j.metadata, std::make_shared<cnf_formula_t>(j.metadata.filename, false), j.task_id));
-				}
-
-				instances_to_get -= j.num_instances_to_start;
-			} // task_mutex.unlock();
+			// every task loads its own copy of the formula when it's executed
+			const std::string filename = j.metadata.filename;
+			std::function<void(task&)> run = [filename](task &t) {
+				load_shared_cnf_formula(filename, [&](const auto cnf_sptr) {
+					make_solver_run(cnf_sptr)(t);
+				}, shared_formula_directory);
+			};
+			std::vector<std::function<void(task&)>> runs(j.num_instances_to_start, run);
 		#endif
 
+		{ // task_mutex.lock();
+			std::lock_guard<std::mutex> lock(task_mutex);
+			for (uint32_t i = 0; i < j.num_instances_to_start; i++) {
+				tasks.push_back(std::make_shared<task>(j.metadata, runs[i], j.task_id));
+			}
+
+			instances_to_get -= j.num_instances_to_start;
+		} // task_mutex.unlock();
+
 		#if DEBUG_WORKER
 			std::cout << msg_header << "added " << j.num_instances_to_start << " tasks" << std::endl;
 		#endif
@@ -293,11 +643,6 @@ void worker_func() {
 
 			assert(t);
 
-			#if USE_PROB_FUNC_LOCAL_CACHE
-				thread_local static prob_func_t tl_pfi = prob_func_t();
-				t->pfi_ptr = &tl_pfi;
-			#endif
-
 			t->execute();
 			// if (!running) return;
 
@@ -324,9 +669,16 @@ void return_task(std::shared_ptr<task> t) {
 			std::cout << msg_header << "found solution!" << std::endl;
 		#endif
 
+		const uint64_t model_hash = t->model.hash();
 		W2S::found_solution fs_cmd({t->dpi.seed, t->dpi.num_flips_done,
-			t->dpi.solve_duration, t->dpi.num_vars, t->dpi.num_clauses, t->name});
+			t->dpi.solve_duration, t->dpi.num_vars, t->dpi.num_clauses, t->name, t->dpi.task_id, model_hash});
 		fs_cmd.send();
+
+		// the model follows in chunks of at most absolute_max_cmd_length bytes
+		for (std::size_t i = 0; i < num_model_chunks(t->model.num_words()); i++) {
+			W2S::send_model sm_cmd(make_model_chunk(t->model, model_hash, i));
+			sm_cmd.send();
+		}
 	}
 
 	if (0 >= t->dpi.instances_processed) {
@@ -338,8 +690,25 @@ void return_task(std::shared_ptr<task> t) {
 			<< "solved after " << t->dpi.num_flips_done << " flips" << std::endl;
 	#endif
 
+	#if TRACK_BEST_ASSIGNMENT
+		// the server keeps the best assignment of an unsolved file (MaxSAT like reporting)
+		if ((!t->dpi.solved) && (0 < t->best_assignment.size())) {
+			t->dpi.min_unsat_hash = t->best_assignment.hash();
+		}
+	#endif
+
 	W2S::done_processing dp_cmd(t->dpi);
 	dp_cmd.send();
+
+	#if TRACK_BEST_ASSIGNMENT
+		// it follows in chunks like a model
+		if (0 != t->dpi.min_unsat_hash) {
+			for (std::size_t i = 0; i < num_model_chunks(t->best_assignment.num_words()); i++) {
+				W2S::send_model sm_cmd(make_model_chunk(t->best_assignment, t->dpi.min_unsat_hash, i));
+				sm_cmd.send();
+			}
+		}
+	#endif
 }
 
 #endif